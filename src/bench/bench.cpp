@@ -0,0 +1,441 @@
+// Microbenchmarks of the simulation and renderer hot paths, run against the
+// null renderer so no window or gpu is needed. Prints JSON with ns/op of every
+// benchmark, cycles/op where the cpu's cycle counter can be read, and the
+// speedup of the batch simulation on 1 to every core, for comparing builds.
+// usage: bench [-font path] [-m matches] [-n ticks] [-o out.json]
+#include "./core/physics.hpp"
+#include "./core/text.hpp"
+#include "./core/allocations.hpp"
+#include "./platform/renderer.hpp"
+#include "./sim/batch.hpp"
+#include "./sim/jobs.hpp"
+#include "./sim/multiball.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+const char* DEFAULT_FONT_PATH = "./resources/HyperspaceBold.otf";
+// every benchmark repeats its op until a run takes at least this long
+const f64 BENCH_MIN_SECONDS = 0.05;
+// and reports the fastest of this many runs
+const u32 BENCH_RUNS = 5;
+// inputs cycled through by the benchmarks that take one, a power of two
+const u32 BENCH_INPUTS = 1024;
+const u64 BENCH_SEED   = 11;
+// longer than any string of the menu
+const u32 BENCH_MAX_TEXT = 64;
+// balls of the multi ball scene drawn as one frame of rectangles
+const u32 BENCH_RECTS    = 4096;
+
+// results land here so the compiler can't drop the work
+volatile f32 g_sink;
+
+// Cycles spent by this thread, through perf_event_open on linux.
+// Reads as unavailable everywhere else, and where the kernel won't allow it.
+struct CycleCounter {
+    i32 fd = -1;
+};
+
+CycleCounter OpenCycleCounter() {
+    CycleCounter result = {};
+#ifdef __linux__
+    perf_event_attr attr = {};
+    attr.type   = PERF_TYPE_HARDWARE;
+    attr.size   = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    result.fd = (i32)syscall( SYS_perf_event_open, &attr, 0, -1, -1, 0 );
+#endif
+    return result;
+}
+
+void CloseCycleCounter( CycleCounter& counter ) {
+#ifdef __linux__
+    if( counter.fd >= 0 ) { close(counter.fd); }
+#endif
+    counter.fd = -1;
+}
+
+bool CyclesAvailable( const CycleCounter& counter ) { return counter.fd >= 0; }
+
+u64 ReadCycles( const CycleCounter& counter ) {
+    u64 result = 0;
+#ifdef __linux__
+    if( counter.fd >= 0 && read(counter.fd, &result, sizeof(result)) != sizeof(result) ) {
+        result = 0;
+    }
+#endif
+    return result;
+}
+
+struct BenchResult {
+    const char* name;
+    u64 ops;
+    f64 nsPerOp;
+    // negative without a cycle counter
+    f64 cyclesPerOp;
+    // heap allocations, negative unless built with COUNT_ALLOCATIONS
+    f64 allocationsPerOp;
+    // draw calls the null renderer was asked for
+    f64 drawsPerOp;
+    // shader, texture and blend changes it would have made
+    f64 stateChangesPerOp;
+};
+
+// Runs op(i) for i counting up from 0 in runs long enough to time,
+// and keeps the fastest run.
+template<typename F>
+BenchResult RunBench( const CycleCounter& counter, const char* name, const F& op ) {
+    u64 iterations = 1;
+    // ops run, calibration included
+    u64 index = 0;
+    BenchResult result = {};
+    result.name = name;
+    result.nsPerOp     = 0.0;
+    result.cyclesPerOp = -1.0;
+    result.allocationsPerOp = -1.0;
+    u64 allocationsStart = AllocationCount();
+    u64 drawsStart = GetNullRendererStats().draws;
+    u64 stateChangesStart = GetNullRendererStats().stateChanges;
+    u32 runs = 0;
+    while( runs < BENCH_RUNS ) {
+        u64 cyclesStart = ReadCycles( counter );
+        auto start = std::chrono::steady_clock::now();
+        for( u64 i = 0; i < iterations; i++ ) { op( index++ ); }
+        f64 seconds = std::chrono::duration<f64>( std::chrono::steady_clock::now() - start ).count();
+        u64 cycles  = ReadCycles( counter ) - cyclesStart;
+
+        // still calibrating
+        if( seconds < BENCH_MIN_SECONDS && runs == 0 ) {
+            iterations *= 2;
+            continue;
+        }
+        f64 nsPerOp = seconds * 1e9 / (f64)iterations;
+        if( runs == 0 || nsPerOp < result.nsPerOp ) {
+            result.nsPerOp = nsPerOp;
+            if( CyclesAvailable(counter) ) { result.cyclesPerOp = (f64)cycles / (f64)iterations; }
+        }
+        result.ops += iterations;
+        runs++;
+    }
+    result.drawsPerOp = (f64)(GetNullRendererStats().draws - drawsStart) / (f64)index;
+    result.stateChangesPerOp = (f64)(GetNullRendererStats().stateChanges - stateChangesStart) / (f64)index;
+    if( ALLOCATIONS_COUNTED ) {
+        result.allocationsPerOp = (f64)(AllocationCount() - allocationsStart) / (f64)index;
+    }
+    return result;
+}
+
+// ball states spread over the field, fed to the benchmarks that take one
+struct BallSample {
+    f32 x; f32 y;
+    f32 dirX; f32 dirY;
+    f32 playerY; f32 cpuY;
+};
+
+std::vector<BallSample> CreateBallSamples( u64 seed ) {
+    std::vector<BallSample> result( BENCH_INPUTS );
+    const GameRules& rules = DEFAULT_RULES;
+    for( u32 i = 0; i < BENCH_INPUTS; i++ ) {
+        // uniform in [-1, 1]
+        auto random = [seed, i]( u32 which ) {
+            return (f32)Squares32( (u64)i * 8 + which, seed ) / 2147483648.0f - 1.0f;
+        };
+        BallSample& sample = result[i];
+        // near the paddles half the time, so collisions hit and miss
+        sample.x = (i & 1) ? random(0) * rules.fieldW : (random(0) > 0.0f ? 1.0f : -1.0f) * rules.paddleX;
+        sample.y = random(1) * rules.fieldH;
+        f32 angle = random(2) * 0.6f;
+        sample.dirX = random(3) > 0.0f ? 1.0f : -1.0f;
+        sample.dirY = angle;
+        sample.playerY = random(4) * (rules.fieldH - rules.PaddleHalfH());
+        sample.cpuY    = random(5) * (rules.fieldH - rules.PaddleHalfH());
+    }
+    return result;
+}
+
+std::vector<u8> ReadFile( const char* path ) {
+    std::vector<u8> result;
+    FILE* file = fopen( path, "rb" );
+    if( !file ) { return result; }
+    fseek( file, 0, SEEK_END );
+    long size = ftell( file );
+    fseek( file, 0, SEEK_SET );
+    if( size > 0 ) {
+        result.resize( (size_t)size );
+        if( fread( result.data(), 1, result.size(), file ) != result.size() ) { result.clear(); }
+    }
+    fclose( file );
+    return result;
+}
+
+void RunSimulationBenches( const CycleCounter& counter, std::vector<BenchResult>& results ) {
+    const DeltaTime ts = 1.0f / 120.0f;
+    std::vector<BallSample> samples = CreateBallSamples( BENCH_SEED );
+
+    Pong pong = Pong( BENCH_SEED );
+    results.push_back( RunBench( counter, "Pong::UpdateGame", [&pong, ts]( u64 ) {
+        const GameState& state = pong.GetGameState();
+        pong.UpdateGame( ts, BotInput( state.ball.x, state.ball.y, state.player.y ) );
+    } ) );
+    g_sink = pong.GetGameState().ball.x;
+
+    results.push_back( RunBench( counter, "BallCollision", [&samples]( u64 i ) {
+        BallSample sample = samples[i & (BENCH_INPUTS - 1)];
+        u32 playerScore = 0, cpuScore = 0, tick = (u32)i;
+        bool scored = false;
+        f32 scoreTimer = 0.0f;
+        u64 rngKey = BENCH_SEED;
+        FixedMatchRef<ClassicRules> match = {
+            sample.x, sample.y, sample.dirX, sample.dirY,
+            sample.playerY, sample.cpuY,
+            playerScore, cpuScore, scored, scoreTimer,
+            rngKey, tick
+        };
+        BallCollision( match );
+        g_sink = sample.dirY;
+    } ) );
+
+    results.push_back( RunBench( counter, "CpuDY", [&samples]( u64 i ) {
+        const BallSample& sample = samples[i & (BENCH_INPUTS - 1)];
+        g_sink = CpuDY( sample.x, sample.y, sample.dirX, sample.dirY, sample.cpuY );
+    } ) );
+}
+
+void RunTextBenches( const CycleCounter& counter, std::vector<u8>& fontBytes, std::vector<BenchResult>& results ) {
+    results.push_back( RunBench( counter, "LoadFontFromBytes", [&fontBytes]( u64 ) {
+        Font font = LoadFontFromBytes( fontBytes.data() );
+        g_sink = (f32)font.glyphs.at('A').width;
+        FreeFont( font );
+    } ) );
+
+    Font font = LoadFontFromBytes( fontBytes.data() );
+    TextMetrics metrics = CreateTextMetrics( font );
+    const UITextElement* menu[] = {
+        &GetTitleText(), &GetStartGameText(), &GetQuitGameText(),
+        &GetControlsText0(), &GetControlsText1(), &GetControlsText2(),
+    };
+    // every string of the menu, one frame's worth of layout
+    results.push_back( RunBench( counter, "LayoutText menu", [&metrics, &menu]( u64 ) {
+        TextQuad quads[BENCH_MAX_TEXT];
+        for( const UITextElement* element : menu ) {
+            u32 count = LayoutText(
+                metrics, element->text, element->xPos, element->yPos,
+                element->scale, element->style, quads, BENCH_MAX_TEXT
+            );
+            g_sink = quads[count - 1].x;
+        }
+    } ) );
+
+    results.push_back( RunBench( counter, "RendererLoadFont", [&font]( u64 ) {
+        RendererLoadFont( font );
+    } ) );
+    FreeFont( font );
+
+    // every op is a frame, the frame arena is reset like the main loop does
+    results.push_back( RunBench( counter, "RenderText", []( u64 ) {
+        ResetArena( FrameArena() );
+        RenderText( GetStartGameText() );
+        RendererEndFrame();
+    } ) );
+    results.push_back( RunBench( counter, "RenderMenu", []( u64 i ) {
+        ResetArena( FrameArena() );
+        RenderMenu( (i & 1) ? MenuOption::QUIT_GAME : MenuOption::START_GAME );
+        RendererEndFrame();
+    } ) );
+}
+
+void RunRenderBenches( const CycleCounter& counter, std::vector<BenchResult>& results ) {
+    std::vector<BallSample> samples = CreateBallSamples( BENCH_SEED );
+    results.push_back( RunBench( counter, "RenderGame", [&samples]( u64 i ) {
+        const BallSample& sample = samples[i & (BENCH_INPUTS - 1)];
+        GameState state = {};
+        state.ball.x   = sample.x;
+        state.ball.y   = sample.y;
+        state.player.y = sample.playerY;
+        state.cpu.y    = sample.cpuY;
+        ResetArena( FrameArena() );
+        RenderGame( state );
+        RendererEndFrame();
+    } ) );
+    // between rounds the score is drawn too
+    results.push_back( RunBench( counter, "RenderGame scored", []( u64 i ) {
+        GameState state = {};
+        state.scored      = true;
+        state.playerScore = (u32)(i % 12);
+        state.cpuScore    = (u32)(i % 7);
+        ResetArena( FrameArena() );
+        RenderGame( state );
+        RendererEndFrame();
+    } ) );
+
+    // a multi ball field, every ball is an instance of the same draw
+    MultiBallState multiBall = CreateMultiBall( BENCH_RECTS, MultiBallSize( BENCH_RECTS, 0.2f ), BENCH_SEED );
+    results.push_back( RunBench( counter, "RenderRects 4096", [&multiBall]( u64 ) {
+        ResetArena( FrameArena() );
+        const MultiBallArrays& balls = multiBall.balls[multiBall.front];
+        RectInstance* rects = ArenaPushArray<RectInstance>( FrameArena(), multiBall.count );
+        for( u32 i = 0; i < multiBall.count; i++ ) {
+            rects[i] = { balls.x[i], balls.y[i], multiBall.rules.ballSize, multiBall.rules.ballSize };
+        }
+        RenderRects( rects, multiBall.count );
+        RendererEndFrame();
+    } ) );
+    FreeMultiBall( multiBall );
+    g_sink = GetNullRendererStats().checksum;
+}
+
+struct ScalingPoint {
+    u32 threads;
+    f64 ticksPerSecond;
+};
+
+// the batch simulation on 1 to every core, the same split as headless
+std::vector<ScalingPoint> RunThreadScaling( u32 matches, u32 ticks ) {
+    std::vector<ScalingPoint> result;
+    const DeltaTime ts = 1.0f / 60.0f;
+    BatchState batch = CreateBatch( matches, BENCH_SEED );
+    u32 cores = CoreCount();
+    for( u32 threads = 1; threads <= cores; threads++ ) {
+        ResetBatch( batch, BENCH_SEED );
+        JobPool pool( threads - 1 );
+        u32 grain = batch.capacity / (threads * 8);
+        if( grain < BATCH_LANE_ALIGN ) { grain = BATCH_LANE_ALIGN; }
+
+        auto start = std::chrono::steady_clock::now();
+        RunBatch( pool, batch, ticks, ts, grain );
+        f64 seconds = std::chrono::duration<f64>( std::chrono::steady_clock::now() - start ).count();
+
+        ScalingPoint point = {};
+        point.threads = threads;
+        point.ticksPerSecond = (f64)matches * (f64)ticks / seconds;
+        result.push_back( point );
+    }
+    FreeBatch( batch );
+    return result;
+}
+
+// JSON has no way to write NaN or infinity, unmeasured values are null
+void WriteNumber( FILE* out, f64 value ) {
+    if( value < 0.0 ) { fprintf(out, "null"); }
+    else { fprintf(out, "%.3f", value); }
+}
+
+void WriteJson(
+    FILE* out, bool cycles, u32 matches, u32 ticks,
+    const std::vector<BenchResult>& results, const std::vector<ScalingPoint>& scaling
+) {
+    fprintf(out, "{\n");
+    fprintf(out, "  \"compiler\": \"%s\",\n", __VERSION__);
+#ifdef __OPTIMIZE__
+    fprintf(out, "  \"optimized\": true,\n");
+#else
+    fprintf(out, "  \"optimized\": false,\n");
+#endif
+    fprintf(out, "  \"simd\": \"%s\",\n", SimdLevelName(DetectSimdLevel()));
+    fprintf(out, "  \"cores\": %u,\n", CoreCount());
+    fprintf(out, "  \"cycleCounter\": %s,\n", cycles ? "true" : "false");
+    fprintf(out, "  \"benchmarks\": [\n");
+    for( size_t i = 0; i < results.size(); i++ ) {
+        const BenchResult& result = results[i];
+        fprintf(out, "    { \"name\": \"%s\", \"ops\": %llu, \"nsPerOp\": ",
+            result.name, (unsigned long long)result.ops);
+        WriteNumber( out, result.nsPerOp );
+        fprintf(out, ", \"cyclesPerOp\": ");
+        WriteNumber( out, result.cyclesPerOp );
+        fprintf(out, ", \"allocationsPerOp\": ");
+        WriteNumber( out, result.allocationsPerOp );
+        fprintf(out, ", \"drawsPerOp\": ");
+        WriteNumber( out, result.drawsPerOp );
+        fprintf(out, ", \"stateChangesPerOp\": ");
+        WriteNumber( out, result.stateChangesPerOp );
+        fprintf(out, " }%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ],\n");
+    fprintf(out, "  \"threadScaling\": {\n");
+    fprintf(out, "    \"matches\": %u,\n", matches);
+    fprintf(out, "    \"ticks\": %u,\n", ticks);
+    fprintf(out, "    \"points\": [\n");
+    for( size_t i = 0; i < scaling.size(); i++ ) {
+        const ScalingPoint& point = scaling[i];
+        f64 speedup = point.ticksPerSecond / scaling[0].ticksPerSecond;
+        fprintf(out, "      { \"threads\": %u, \"ticksPerSecond\": %.0f, \"speedup\": %.3f, \"efficiency\": %.3f }%s\n",
+            point.threads, point.ticksPerSecond, speedup, speedup / point.threads,
+            i + 1 < scaling.size() ? "," : "");
+    }
+    fprintf(out, "    ]\n");
+    fprintf(out, "  }\n");
+    fprintf(out, "}\n");
+}
+
+void PrintSummary( const std::vector<BenchResult>& results, const std::vector<ScalingPoint>& scaling ) {
+    for( const BenchResult& result : results ) {
+        printf("%-20s %12.1f ns/op", result.name, result.nsPerOp);
+        if( result.cyclesPerOp >= 0.0 ) { printf(" %12.1f cycles/op", result.cyclesPerOp); }
+        if( result.allocationsPerOp >= 0.0 ) { printf(" %8.2f allocations/op", result.allocationsPerOp); }
+        if( result.drawsPerOp > 0.0 ) { printf(" %6.1f draws/op", result.drawsPerOp); }
+        if( result.stateChangesPerOp > 0.0 ) { printf(" %6.2f state changes/op", result.stateChangesPerOp); }
+        printf("\n");
+    }
+    for( const ScalingPoint& point : scaling ) {
+        printf("%2u threads %14.0f ticks/s %6.2fx\n",
+            point.threads, point.ticksPerSecond, point.ticksPerSecond / scaling[0].ticksPerSecond);
+    }
+}
+
+int main( int argc, char** argv ) {
+    const char* fontPath = DEFAULT_FONT_PATH;
+    const char* outPath  = nullptr;
+    u32 matches = 16384;
+    u32 ticks   = 2000;
+    for( int i = 1; i + 1 < argc; i += 2 ) {
+        if( strcmp(argv[i], "-font") == 0 )   { fontPath = argv[i + 1]; }
+        else if( strcmp(argv[i], "-o") == 0 ) { outPath  = argv[i + 1]; }
+        else if( strcmp(argv[i], "-m") == 0 ) { matches  = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-n") == 0 ) { ticks    = (u32)atoi(argv[i + 1]); }
+    }
+    if( matches == 0 || ticks == 0 ) {
+        printf("usage: bench [-font path] [-m matches] [-n ticks] [-o out.json]\n");
+        return -1;
+    }
+
+    CycleCounter counter = OpenCycleCounter();
+    std::vector<BenchResult> results;
+    InitializeRenderer();
+    RunSimulationBenches( counter, results );
+
+    std::vector<u8> fontBytes = ReadFile( fontPath );
+    if( !fontBytes.empty() ) {
+        RunTextBenches( counter, fontBytes, results );
+    } else {
+        fprintf(stderr, "can't read %s, skipping the text benchmarks\n", fontPath);
+    }
+    RunRenderBenches( counter, results );
+    std::vector<ScalingPoint> scaling = RunThreadScaling( matches, ticks );
+
+    bool cycles = CyclesAvailable( counter );
+    CloseCycleCounter( counter );
+
+    if( !outPath ) {
+        WriteJson( stdout, cycles, matches, ticks, results, scaling );
+        return 0;
+    }
+    FILE* out = fopen( outPath, "w" );
+    if( !out ) {
+        fprintf(stderr, "can't write %s\n", outPath);
+        return -1;
+    }
+    WriteJson( out, cycles, matches, ticks, results, scaling );
+    fclose( out );
+    PrintSummary( results, scaling );
+    return 0;
+}
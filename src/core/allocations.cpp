@@ -0,0 +1,37 @@
+#include "allocations.hpp"
+
+#ifdef COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+std::atomic<u64> g_allocationCount{0};
+
+u64 AllocationCount() { return g_allocationCount.load(std::memory_order_relaxed); }
+
+void* operator new( size_t size ) {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    void* result = malloc( size ? size : 1 );
+    if( !result ) { throw std::bad_alloc(); }
+    return result;
+}
+void* operator new[]( size_t size ) { return operator new( size ); }
+void* operator new( size_t size, const std::nothrow_t& ) noexcept {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return malloc( size ? size : 1 );
+}
+void* operator new[]( size_t size, const std::nothrow_t& tag ) noexcept { return operator new( size, tag ); }
+
+void operator delete( void* memory ) noexcept { free( memory ); }
+void operator delete[]( void* memory ) noexcept { free( memory ); }
+void operator delete( void* memory, size_t ) noexcept { free( memory ); }
+void operator delete[]( void* memory, size_t ) noexcept { free( memory ); }
+void operator delete( void* memory, const std::nothrow_t& ) noexcept { free( memory ); }
+void operator delete[]( void* memory, const std::nothrow_t& ) noexcept { free( memory ); }
+
+#else
+
+u64 AllocationCount() { return 0; }
+
+#endif
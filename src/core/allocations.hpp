@@ -0,0 +1,19 @@
+#pragma once
+#include "defines.hpp"
+
+// Debug builds count every call to the global operator new, so code that
+// must not touch the heap (a frame after start up) can check that it didn't.
+// Define COUNT_ALLOCATIONS to count in other builds too.
+// Aligned new isn't counted, only big blocks made at start up use it.
+#if defined(DEBUG) && !defined(COUNT_ALLOCATIONS)
+#define COUNT_ALLOCATIONS
+#endif
+
+#ifdef COUNT_ALLOCATIONS
+constexpr bool ALLOCATIONS_COUNTED = true;
+#else
+constexpr bool ALLOCATIONS_COUNTED = false;
+#endif
+
+// heap allocations made so far by every thread, always 0 when not counting
+u64 AllocationCount();
@@ -1,5 +1,7 @@
 #pragma once
 #include "globals.hpp"
+#include "rules.hpp"
+#include "rng.hpp"
 #include <glm/vec2.hpp>
 #include "ui.hpp"
 
@@ -14,16 +16,20 @@ enum MenuOption {
     QUIT_GAME,
 };
 
-struct Paddle { f32 y; };
-struct Ball   { f32 x; f32 y; glm::vec2 direction; };
-struct GameState {
-    Paddle player;
-    Paddle cpu;
-    Ball   ball;
+template<typename Real> struct BasicPaddle { Real y; };
+template<typename Real> struct BasicBall   { Real x; Real y; glm::vec<2, Real> direction; };
+template<typename Real>
+struct BasicGameState {
+    BasicPaddle<Real> player;
+    BasicPaddle<Real> cpu;
+    BasicBall<Real>   ball;
     u32    playerScore;
     u32    cpuScore;
     bool   scored;
 };
+using Paddle    = BasicPaddle<f32>;
+using Ball      = BasicBall<f32>;
+using GameState = BasicGameState<f32>;
 
 struct PlayerInput {
     bool up;
@@ -31,32 +37,67 @@ struct PlayerInput {
     bool enter;
 };
 
-class Pong {
+// Everything needed to put a Pong back exactly where it was,
+// including the state Pong doesn't expose.
+template<typename Real>
+struct BasicPongSnapshot {
+    BasicGameState<Real> gameState;
+    Scene      scene;
+    MenuOption selectedMenuOption;
+    Real       scoreTimer;
+    bool       lastUp;
+    bool       lastDown;
+    u64        rngKey;
+    u32        tick;
+};
+using PongSnapshot = BasicPongSnapshot<f32>;
+
+template<typename Rules> struct FixedMatchRef;
+
+// One match played by a rule set from rules.hpp, see ClassicRules.
+// Defined in app.cpp, which builds every rule set listed at the end of this file.
+template<typename Rules>
+class BasicPong {
 public:
-    Pong();
+    using Real      = typename Rules::Real;
+    using GameState = BasicGameState<Real>;
+    using Snapshot  = BasicPongSnapshot<Real>;
+
+    BasicPong( u64 seed = DEFAULT_RNG_SEED, u32 matchId = 0 );
     void UpdateMenu(const PlayerInput& input);
     void UpdateGame( DeltaTime ts, const PlayerInput& input );
+    // both paddles played by inputs, cpuInput moves the right one
+    void UpdateGame( DeltaTime ts, const PlayerInput& input, const PlayerInput& cpuInput );
     const GameState& GetGameState() { return m_gameState; }
     Scene CurrentScene() { return m_currentScene; }
     MenuOption GetSelectedMenuOption() { return m_selectedMenuOption; }
+    // game ticks simulated so far
+    u32 CurrentTick() const { return m_tick; }
+
+    void SaveSnapshot( Snapshot& snapshot ) const;
+    void RestoreSnapshot( const Snapshot& snapshot );
 private:
     GameState m_gameState;
-    static f32 MovePaddle(const f32&, const f32&);
-    static f32 PlayerDY(const PlayerInput&);
-    f32 CpuDY();
-    void MoveBallX(const f32&);
-    void MoveBallY(const f32&);
-    void BallCollision();
-    void ResetBall();
+    FixedMatchRef<Rules> Match();
 
     Scene m_currentScene;
     MenuOption m_selectedMenuOption = MenuOption::START_GAME;
 
-    f32 m_scoreTimer = 0.0f;
+    Real m_scoreTimer = 0.0f;
     bool m_lastUp   = false;
     bool m_lastDown = false;
+
+    u64 m_rngKey;
+    u32 m_tick = 0;
 };
 
+extern template class BasicPong<ClassicRules>;
+extern template class BasicPong<PreciseRules>;
+extern template class BasicPong<FastRules>;
+extern template class BasicPong<TunableRules>;
+extern template class BasicPong<FixedPointRules>;
+using Pong = BasicPong<ClassicRules>;
+
 const glm::vec3 SELECT_COLOR   = glm::vec3(1.0f);
 const glm::vec3 DESELECT_COLOR = glm::vec3(0.5f);
 
@@ -0,0 +1,27 @@
+#include "arena.hpp"
+#include <new>
+
+Arena CreateArena( size_t capacity ) {
+    Arena result = {};
+    result.memory   = (u8*)::operator new( capacity, std::align_val_t(ARENA_ALIGN) );
+    result.capacity = capacity;
+    result.used     = 0;
+    return result;
+}
+
+void FreeArena( Arena& arena ) {
+    ::operator delete( arena.memory, std::align_val_t(ARENA_ALIGN) );
+    arena = {};
+}
+
+void* ArenaPush( Arena& arena, size_t size, size_t align ) {
+    size_t start = (arena.used + align - 1) & ~(align - 1);
+    if( start + size > arena.capacity ) { return nullptr; }
+    arena.used = start + size;
+    return arena.memory + start;
+}
+
+Arena& FrameArena() {
+    static Arena arena = CreateArena( FRAME_ARENA_SIZE );
+    return arena;
+}
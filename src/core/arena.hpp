@@ -0,0 +1,31 @@
+#pragma once
+#include "defines.hpp"
+#include <cstddef>
+
+// Bump allocator. Pushes hand out the next bytes of one block of memory and
+// everything is freed at once by a reset, so short lived data costs a pointer
+// add instead of a heap allocation.
+struct Arena {
+    u8* memory;
+    size_t capacity;
+    size_t used;
+};
+
+const size_t ARENA_ALIGN = 64;
+// enough for every string and vertex of a frame many times over
+const size_t FRAME_ARENA_SIZE = 1 << 20;
+
+Arena CreateArena( size_t capacity );
+void FreeArena( Arena& arena );
+// nullptr when the arena is full, the memory is not cleared
+void* ArenaPush( Arena& arena, size_t size, size_t align = alignof(std::max_align_t) );
+inline void ResetArena( Arena& arena ) { arena.used = 0; }
+
+template<typename T>
+T* ArenaPushArray( Arena& arena, size_t count ) {
+    return (T*)ArenaPush( arena, sizeof(T) * count, alignof(T) );
+}
+
+// Memory that lives until the end of the frame, reset at the top of the main loop.
+// Created the first time it's asked for.
+Arena& FrameArena();
@@ -0,0 +1,163 @@
+#include "atlas.hpp"
+#include <algorithm>
+#include <cstring>
+
+SkylinePacker CreateSkylinePacker( u32 width, u32 height ) {
+    SkylinePacker result = {};
+    result.width  = width;
+    result.height = height;
+    result.skyline.push_back( SkylineNode{ 0, 0, width } );
+    return result;
+}
+
+// how high a w wide rectangle sits when its left edge is on node index,
+// false if it runs off the right or the top
+bool SkylineFits( const SkylinePacker& packer, u32 index, u32 w, u32 h, u32& y ) {
+    u32 x = packer.skyline[index].x;
+    if( x + w > packer.width ) { return false; }
+    y = 0;
+    u32 covered = 0;
+    for( u32 i = index; covered < w; i++ ) {
+        const SkylineNode& node = packer.skyline[i];
+        if( node.y > y ) { y = node.y; }
+        covered += node.w;
+    }
+    return y + h <= packer.height;
+}
+
+bool PackRect( SkylinePacker& packer, u32 w, u32 h, u32& x, u32& y ) {
+    u32 bestIndex  = ~0u;
+    u32 bestTop    = ~0u;
+    u32 bestWidth  = ~0u;
+    for( u32 i = 0; i < (u32)packer.skyline.size(); i++ ) {
+        u32 top = 0;
+        if( !SkylineFits( packer, i, w, h, top ) ) { continue; }
+        // lowest top, then the narrowest segment to waste the least
+        if( top + h < bestTop || (top + h == bestTop && packer.skyline[i].w < bestWidth) ) {
+            bestIndex = i;
+            bestTop   = top + h;
+            bestWidth = packer.skyline[i].w;
+        }
+    }
+    if( bestIndex == ~0u ) { return false; }
+
+    x = packer.skyline[bestIndex].x;
+    y = bestTop - h;
+    if( w == 0 ) { return true; }
+
+    std::vector<SkylineNode>& skyline = packer.skyline;
+    skyline.insert( skyline.begin() + bestIndex, SkylineNode{ x, bestTop, w } );
+    // cut back the segments now under the new one
+    for( u32 i = bestIndex + 1; i < (u32)skyline.size(); ) {
+        SkylineNode& node = skyline[i];
+        u32 right = x + w;
+        if( node.x >= right ) { break; }
+        if( node.x + node.w <= right ) {
+            skyline.erase( skyline.begin() + i );
+            continue;
+        }
+        node.w -= right - node.x;
+        node.x  = right;
+        break;
+    }
+    // join neighbours at the same height
+    for( u32 i = 0; i + 1 < (u32)skyline.size(); ) {
+        if( skyline[i].y == skyline[i + 1].y ) {
+            skyline[i].w += skyline[i + 1].w;
+            skyline.erase( skyline.begin() + i + 1 );
+        } else {
+            i++;
+        }
+    }
+    return true;
+}
+
+// packs every glyph into a size by size square, false if they don't fit
+bool PackGlyphs( const Font& font, u32 size, FontAtlas& atlas ) {
+    // tallest first packs tightest
+    u32 order[TEXT_GLYPH_COUNT];
+    for( u32 c = 0; c < TEXT_GLYPH_COUNT; c++ ) { order[c] = c; }
+    std::sort( order, order + TEXT_GLYPH_COUNT, [&font]( u32 a, u32 b ) {
+        i32 heightA = font.glyphs.at((u8)a).height;
+        i32 heightB = font.glyphs.at((u8)b).height;
+        return heightA != heightB ? heightA > heightB : a < b;
+    } );
+
+    SkylinePacker packer = CreateSkylinePacker( size, size );
+    for( u32 c : order ) {
+        const Glyph& glyph = font.glyphs.at((u8)c);
+        AtlasRect& rect = atlas.glyphs[c];
+        rect = {};
+        if( glyph.width <= 0 || glyph.height <= 0 || !glyph.bitmap ) { continue; }
+        u32 x, y;
+        if( !PackRect( packer, glyph.width + ATLAS_PADDING * 2, glyph.height + ATLAS_PADDING * 2, x, y ) ) {
+            return false;
+        }
+        rect.x = x + ATLAS_PADDING;
+        rect.y = y + ATLAS_PADDING;
+        rect.w = glyph.width;
+        rect.h = glyph.height;
+    }
+    return true;
+}
+
+FontAtlas CreateFontAtlas( const Font& font ) {
+    FontAtlas result = {};
+    u32 size = ATLAS_MIN_SIZE;
+    while( !PackGlyphs( font, size, result ) ) {
+        size *= 2;
+        if( size > ATLAS_MAX_SIZE ) { return result; }
+    }
+
+    result.width  = size;
+    result.height = size;
+    result.pixels = new u8[size * size];
+    memset( result.pixels, 0, size * size );
+    for( u32 c = 0; c < TEXT_GLYPH_COUNT; c++ ) {
+        const AtlasRect& rect = result.glyphs[c];
+        const u8* bitmap = font.glyphs.at((u8)c).bitmap;
+        for( u32 row = 0; row < rect.h; row++ ) {
+            memcpy( result.pixels + (rect.y + row) * size + rect.x, bitmap + row * rect.w, rect.w );
+        }
+    }
+    return result;
+}
+
+void FreeFontAtlasPixels( FontAtlas& atlas ) {
+    delete[] atlas.pixels;
+    atlas.pixels = nullptr;
+}
+
+u32 WriteTextVertices(
+    const FontAtlas& atlas, const TextQuad* quads, u32 count,
+    const glm::vec3& color, TextVertex* vertices
+) {
+    u32 written = 0;
+    f32 invW = 1.0f / atlas.width;
+    f32 invH = 1.0f / atlas.height;
+    for( u32 i = 0; i < count; i++ ) {
+        const TextQuad& quad = quads[i];
+        if( quad.character >= TEXT_GLYPH_COUNT ) { continue; }
+        const AtlasRect& rect = atlas.glyphs[quad.character];
+        if( rect.w == 0 || rect.h == 0 ) { continue; }
+
+        // the bitmap's top row is at v0, drawn at the top of the quad
+        f32 u0 = rect.x * invW;
+        f32 v0 = rect.y * invH;
+        f32 u1 = (rect.x + rect.w) * invW;
+        f32 v1 = (rect.y + rect.h) * invH;
+        f32 left   = quad.x;
+        f32 right  = quad.x + quad.w;
+        f32 bottom = quad.y;
+        f32 top    = quad.y + quad.h;
+        TextVertex* out = vertices + written;
+        out[0] = { left,  top,    u0, v0, color.x, color.y, color.z };
+        out[1] = { left,  bottom, u0, v1, color.x, color.y, color.z };
+        out[2] = { right, bottom, u1, v1, color.x, color.y, color.z };
+        out[3] = { left,  top,    u0, v0, color.x, color.y, color.z };
+        out[4] = { right, bottom, u1, v1, color.x, color.y, color.z };
+        out[5] = { right, top,    u1, v0, color.x, color.y, color.z };
+        written += TEXT_VERTICES_PER_GLYPH;
+    }
+    return written;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "defines.hpp"
+#include "font.hpp"
+#include "text.hpp"
+#include <vector>
+
+// Packs every glyph of a font into one texture, so all text can be drawn
+// with one texture bound.
+
+// Skyline bin packer. Keeps the top edge of what's been packed as a list of
+// horizontal segments and puts each rectangle where its top ends up lowest.
+struct SkylineNode {
+    u32 x;
+    u32 y;
+    u32 w;
+};
+
+struct SkylinePacker {
+    u32 width;
+    u32 height;
+    // left to right, covering the whole width
+    std::vector<SkylineNode> skyline;
+};
+
+SkylinePacker CreateSkylinePacker( u32 width, u32 height );
+// finds room for a w by h rectangle, false once it doesn't fit anywhere
+bool PackRect( SkylinePacker& packer, u32 w, u32 h, u32& x, u32& y );
+
+// empty pixels around every glyph, so filtering doesn't pick up its neighbours
+const u32 ATLAS_PADDING   = 1;
+const u32 ATLAS_MIN_SIZE  = 128;
+const u32 ATLAS_MAX_SIZE  = 4096;
+
+// where a glyph is in the atlas, in pixels
+struct AtlasRect {
+    u32 x; u32 y;
+    u32 w; u32 h;
+};
+
+struct FontAtlas {
+    u32 width;
+    u32 height;
+    // one byte per pixel, top row first like the glyph bitmaps
+    u8* pixels;
+    AtlasRect glyphs[TEXT_GLYPH_COUNT];
+};
+
+// the smallest power of two square, from ATLAS_MIN_SIZE up, every glyph fits in.
+// pixels is nullptr if they don't fit in ATLAS_MAX_SIZE.
+FontAtlas CreateFontAtlas( const Font& font );
+// frees the pixels once they're uploaded, the glyph rects stay usable
+void FreeFontAtlasPixels( FontAtlas& atlas );
+
+// one corner of a glyph, every glyph is two triangles
+struct TextVertex {
+    f32 x; f32 y;
+    f32 u; f32 v;
+    f32 r; f32 g; f32 b;
+};
+const u32 TEXT_VERTICES_PER_GLYPH = 6;
+
+// writes the triangles of count laid out glyphs in color, leaving out the
+// ones with nothing to draw, and returns how many vertices it wrote
+u32 WriteTextVertices(
+    const FontAtlas& atlas, const TextQuad* quads, u32 count,
+    const glm::vec3& color, TextVertex* vertices
+);
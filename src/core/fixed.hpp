@@ -0,0 +1,92 @@
+#pragma once
+#include "defines.hpp"
+#include <cmath>
+
+// Signed fixed point number with FRACTION_BITS bits after the point, stored in
+// an i32. Every operation is integer math, so a match stepped in fixed point
+// ends in the same bits on any compiler, flags or cpu. Floats convert in by
+// rounding to the nearest step and saturate at the ends of the range, which
+// is how the shared physics mixes in its float literals and DeltaTime.
+template<u32 FRACTION_BITS>
+struct BasicFixed {
+    static constexpr i64 ONE = (i64)1 << FRACTION_BITS;
+    static constexpr f32 MAX_FLOAT = (f32)(INT32_MAX >> FRACTION_BITS);
+
+    i32 raw;
+
+    BasicFixed() = default;
+    constexpr BasicFixed( f32 value ) : raw( FromFloat(value) ) {}
+    constexpr BasicFixed( f64 value ) : raw( FromFloat((f32)value) ) {}
+
+    static constexpr BasicFixed FromRaw( i32 raw ) {
+        BasicFixed result = {};
+        result.raw = raw;
+        return result;
+    }
+    static constexpr i32 FromFloat( f32 value ) {
+        if( value >= MAX_FLOAT )  { return INT32_MAX; }
+        if( value <= -MAX_FLOAT ) { return -INT32_MAX; }
+        // scaling by a power of two is exact, only the rounding is left
+        f32 scaled = value * (f32)ONE;
+        return (i32)(scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f);
+    }
+    constexpr f32 ToFloat() const { return (f32)raw / (f32)ONE; }
+
+    constexpr BasicFixed operator-() const { return FromRaw(-raw); }
+    friend constexpr BasicFixed operator+( BasicFixed a, BasicFixed b ) { return FromRaw(a.raw + b.raw); }
+    friend constexpr BasicFixed operator-( BasicFixed a, BasicFixed b ) { return FromRaw(a.raw - b.raw); }
+    friend constexpr BasicFixed operator*( BasicFixed a, BasicFixed b ) {
+        return FromRaw( (i32)(((i64)a.raw * b.raw) >> FRACTION_BITS) );
+    }
+    friend constexpr BasicFixed operator/( BasicFixed a, BasicFixed b ) {
+        return FromRaw( (i32)(((i64)a.raw * ONE) / b.raw) );
+    }
+    BasicFixed& operator+=( BasicFixed b ) { raw += b.raw; return *this; }
+    BasicFixed& operator-=( BasicFixed b ) { raw -= b.raw; return *this; }
+    BasicFixed& operator*=( BasicFixed b ) { *this = *this * b; return *this; }
+
+    friend constexpr bool operator==( BasicFixed a, BasicFixed b ) { return a.raw == b.raw; }
+    friend constexpr bool operator!=( BasicFixed a, BasicFixed b ) { return a.raw != b.raw; }
+    friend constexpr bool operator<( BasicFixed a, BasicFixed b )  { return a.raw < b.raw; }
+    friend constexpr bool operator>( BasicFixed a, BasicFixed b )  { return a.raw > b.raw; }
+    friend constexpr bool operator<=( BasicFixed a, BasicFixed b ) { return a.raw <= b.raw; }
+    friend constexpr bool operator>=( BasicFixed a, BasicFixed b ) { return a.raw >= b.raw; }
+};
+using Fixed = BasicFixed<16>;
+
+// Math the physics needs from every Real it runs in.
+inline f32 Abs( f32 x ) { return fabsf(x); }
+inline f64 Abs( f64 x ) { return fabs(x); }
+inline f32 Sqrt( f32 x ) { return sqrtf(x); }
+inline f64 Sqrt( f64 x ) { return sqrt(x); }
+inline f32 Min( f32 a, f32 b ) { return fminf(a, b); }
+inline f64 Min( f64 a, f64 b ) { return fmin(a, b); }
+inline f32 Max( f32 a, f32 b ) { return fmaxf(a, b); }
+inline f64 Max( f64 a, f64 b ) { return fmax(a, b); }
+inline i32 FloorToInt( f32 x ) { return (i32)floorf(x); }
+inline i32 FloorToInt( f64 x ) { return (i32)floor(x); }
+
+template<u32 F> BasicFixed<F> Abs( BasicFixed<F> x ) { return x.raw < 0 ? -x : x; }
+template<u32 F> BasicFixed<F> Min( BasicFixed<F> a, BasicFixed<F> b ) { return a < b ? a : b; }
+template<u32 F> BasicFixed<F> Max( BasicFixed<F> a, BasicFixed<F> b ) { return a > b ? a : b; }
+template<u32 F> i32 FloorToInt( BasicFixed<F> x ) { return x.raw >> F; }
+
+// bit by bit integer square root of the raw value shifted up by the fraction
+template<u32 F>
+BasicFixed<F> Sqrt( BasicFixed<F> x ) {
+    if( x.raw <= 0 ) { return BasicFixed<F>::FromRaw(0); }
+    u64 value  = (u64)x.raw << F;
+    u64 result = 0;
+    u64 bit    = (u64)1 << 62;
+    while( bit > value ) { bit >>= 2; }
+    while( bit ) {
+        if( value >= result + bit ) {
+            value  -= result + bit;
+            result  = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return BasicFixed<F>::FromRaw( (i32)result );
+}
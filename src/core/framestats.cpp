@@ -0,0 +1,117 @@
+#include "framestats.hpp"
+#include <cstring>
+
+u32 HistogramBucket( u64 micros ) {
+    if( micros < FRAME_HISTOGRAM_SUB_BUCKETS ) { return (u32)micros; }
+    u32 msb = 63 - (u32)__builtin_clzll(micros);
+    u32 shift = msb - FRAME_HISTOGRAM_SUB_BITS;
+    // the top FRAME_HISTOGRAM_SUB_BITS + 1 bits of micros, from the leading one
+    u32 bucket = shift * FRAME_HISTOGRAM_SUB_BUCKETS + (u32)(micros >> shift);
+    return bucket < FRAME_HISTOGRAM_BUCKETS ? bucket : FRAME_HISTOGRAM_BUCKETS - 1;
+}
+
+// largest time that lands in bucket
+u64 BucketHighest( u32 bucket ) {
+    if( bucket < 2 * FRAME_HISTOGRAM_SUB_BUCKETS ) { return bucket; }
+    u32 shift = bucket / FRAME_HISTOGRAM_SUB_BUCKETS - 1;
+    u64 mantissa = bucket - shift * FRAME_HISTOGRAM_SUB_BUCKETS;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+const char* FramePhaseName( FramePhase phase ) {
+    switch(phase) {
+        case FramePhase::FRAME:    return "frame";
+        case FramePhase::MESSAGES: return "messages";
+        case FramePhase::UPDATE:   return "update";
+        case FramePhase::CLEAR:    return "clear";
+        case FramePhase::RENDER:   return "render";
+        case FramePhase::SWAP:     return "swap";
+        default:                   return "unknown";
+    }
+}
+
+void RecordTime( FrameHistogram& histogram, f64 seconds ) {
+    u64 micros = seconds > 0.0 ? (u64)(seconds * 1e6 + 0.5) : 0;
+    histogram.counts[HistogramBucket(micros)]++;
+    histogram.total++;
+    histogram.sum += micros;
+    if( micros > histogram.max ) { histogram.max = micros; }
+}
+
+f64 Percentile( const FrameHistogram& histogram, f64 percent ) {
+    if( histogram.total == 0 ) { return 0.0; }
+    // rank of the time asked for, counting from 1
+    u64 rank = (u64)(percent / 100.0 * histogram.total + 0.5);
+    if( rank < 1 ) { rank = 1; }
+    u64 seen = 0;
+    for( u32 bucket = 0; bucket < FRAME_HISTOGRAM_BUCKETS; bucket++ ) {
+        seen += histogram.counts[bucket];
+        if( seen >= rank ) {
+            u64 micros = BucketHighest(bucket);
+            // the slowest time is known exactly
+            return (micros < histogram.max ? micros : histogram.max) / 1e6;
+        }
+    }
+    return histogram.max / 1e6;
+}
+
+f64 SlowestMean( const FrameHistogram& histogram, f64 percent ) {
+    if( histogram.total == 0 ) { return 0.0; }
+    u64 wanted = (u64)(percent / 100.0 * histogram.total + 0.5);
+    if( wanted < 1 ) { wanted = 1; }
+    u64 taken = 0;
+    f64 sum   = 0.0;
+    for( u32 bucket = FRAME_HISTOGRAM_BUCKETS; bucket-- > 0 && taken < wanted; ) {
+        u64 count = histogram.counts[bucket];
+        if( count > wanted - taken ) { count = wanted - taken; }
+        u64 micros = BucketHighest(bucket);
+        sum   += (f64)count * (micros < histogram.max ? micros : histogram.max);
+        taken += count;
+    }
+    return sum / (f64)taken / 1e6;
+}
+
+FrameStats CreateFrameStats( f32 hitchSeconds ) {
+    FrameStats result;
+    memset( &result, 0, sizeof(result) );
+    result.hitchSeconds = hitchSeconds;
+    return result;
+}
+
+void RecordFrame( FrameStats& stats, f64 seconds ) {
+    RecordTime( stats.phases[FramePhase::FRAME], seconds );
+    if( seconds > stats.hitchSeconds ) { stats.hitches++; }
+}
+
+void RecordFramePhase( FrameStats& stats, FramePhase phase, f64 seconds ) {
+    RecordTime( stats.phases[phase], seconds );
+}
+
+// frames per second from seconds per frame, 0 without frames
+f64 FramesPerSecond( f64 seconds ) { return seconds > 0.0 ? 1.0 / seconds : 0.0; }
+
+void WriteFrameStats( const FrameStats& stats, FILE* out ) {
+    const FrameHistogram& frames = stats.phases[FramePhase::FRAME];
+    fprintf(out, "%llu frames, %llu hitches over %.1f ms (%.2f%%)\n",
+        (unsigned long long)frames.total, (unsigned long long)stats.hitches,
+        stats.hitchSeconds * 1e3,
+        frames.total ? 100.0 * stats.hitches / frames.total : 0.0);
+    fprintf(out, "phase          mean ms    p50 ms    p95 ms    p99 ms    max ms\n");
+    for( u32 phase = 0; phase < FRAME_PHASE_COUNT; phase++ ) {
+        const FrameHistogram& histogram = stats.phases[phase];
+        if( histogram.total == 0 ) { continue; }
+        fprintf(out, "%-10s %10.3f %9.3f %9.3f %9.3f %9.3f\n",
+            FramePhaseName((FramePhase)phase),
+            histogram.sum / (f64)histogram.total / 1e3,
+            Percentile(histogram, 50.0) * 1e3,
+            Percentile(histogram, 95.0) * 1e3,
+            Percentile(histogram, 99.0) * 1e3,
+            histogram.max / 1e3);
+    }
+    if( frames.total > 0 ) {
+        fprintf(out, "average %.1f fps, 1%% low %.1f fps, 0.1%% low %.1f fps\n",
+            FramesPerSecond(frames.sum / 1e6 / (f64)frames.total),
+            FramesPerSecond(SlowestMean(frames, 1.0)),
+            FramesPerSecond(SlowestMean(frames, 0.1)));
+    }
+}
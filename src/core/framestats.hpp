@@ -0,0 +1,55 @@
+#pragma once
+#include "defines.hpp"
+#include <cstdio>
+
+// Always on frame time statistics, cheap enough to leave in release builds.
+// Times go into log-linear histograms (like HdrHistogram): every power of two
+// of microseconds is split into FRAME_HISTOGRAM_SUB_BUCKETS buckets, so any
+// percentile is within about 3% of the real time and recording is a few
+// integer ops with no allocation.
+
+const u32 FRAME_HISTOGRAM_SUB_BITS    = 5;
+const u32 FRAME_HISTOGRAM_SUB_BUCKETS = 1 << FRAME_HISTOGRAM_SUB_BITS;
+// up to 2^32 microseconds, longer times land in the last bucket
+const u32 FRAME_HISTOGRAM_BUCKETS     = (32 - FRAME_HISTOGRAM_SUB_BITS + 1) * FRAME_HISTOGRAM_SUB_BUCKETS;
+// frames slower than this count as hitches, two frames at 60 hz
+const f32 DEFAULT_HITCH_SECONDS       = 2.0f / 60.0f;
+
+struct FrameHistogram {
+    u64 counts[FRAME_HISTOGRAM_BUCKETS];
+    u64 total;
+    // microseconds
+    u64 sum;
+    u64 max;
+};
+
+enum FramePhase {
+    FRAME = 0,
+    MESSAGES,
+    UPDATE,
+    CLEAR,
+    RENDER,
+    SWAP,
+    FRAME_PHASE_COUNT
+};
+
+struct FrameStats {
+    FrameHistogram phases[FRAME_PHASE_COUNT];
+    f32 hitchSeconds;
+    u64 hitches;
+};
+
+const char* FramePhaseName( FramePhase phase );
+
+void RecordTime( FrameHistogram& histogram, f64 seconds );
+// seconds at or below which percent of the recorded times are
+f64 Percentile( const FrameHistogram& histogram, f64 percent );
+// average of the slowest percent of the times, the "1% low" is 1 / SlowestMean(1)
+f64 SlowestMean( const FrameHistogram& histogram, f64 percent );
+
+FrameStats CreateFrameStats( f32 hitchSeconds = DEFAULT_HITCH_SECONDS );
+// a whole frame, counted as a hitch if it's over hitchSeconds
+void RecordFrame( FrameStats& stats, f64 seconds );
+void RecordFramePhase( FrameStats& stats, FramePhase phase, f64 seconds );
+// a table of every phase's percentiles, and the frame rate lows
+void WriteFrameStats( const FrameStats& stats, FILE* out );
@@ -0,0 +1,313 @@
+#pragma once
+#include "globals.hpp"
+#include "rules.hpp"
+#include "fixed.hpp"
+#include "app.hpp"
+#include "rng.hpp"
+#include <cmath>
+
+// References to the state of a single match.
+// Lets Pong (array of structs) and the headless batch (struct of arrays)
+// share the exact same step code. Real is f32 everywhere but in
+// BasicPong rule sets that ask for more precision.
+template<typename RealType>
+struct BasicMatchRef {
+    using Real = RealType;
+    Real& ballX;
+    Real& ballY;
+    Real& dirX;
+    Real& dirY;
+    Real& playerY;
+    Real& cpuY;
+    u32& playerScore;
+    u32& cpuScore;
+    bool& scored;
+    Real& scoreTimer;
+    u64& rngKey;
+    u32& tick;
+    const BasicGameRules<Real>& rules;
+};
+using MatchRef = BasicMatchRef<f32>;
+
+// A match playing by a rule set from rules.hpp. rules is part of the type
+// instead of a member, so every step function below gets its own copy for
+// each rule set with the values folded into it.
+template<typename Rules>
+struct FixedMatchRef {
+    using Real = typename Rules::Real;
+    Real& ballX;
+    Real& ballY;
+    Real& dirX;
+    Real& dirY;
+    Real& playerY;
+    Real& cpuY;
+    u32& playerScore;
+    u32& cpuScore;
+    bool& scored;
+    Real& scoreTimer;
+    u64& rngKey;
+    u32& tick;
+    static constexpr const BasicGameRules<Real>& rules = Rules::VALUES;
+};
+
+template<typename Real>
+inline Real MovePaddle( Real paddleY, Real delta, const BasicGameRules<Real>& rules ) {
+    Real result = paddleY + delta;
+    Real test_top    = result + rules.PaddleHalfH();
+    Real test_bottom = result - rules.PaddleHalfH();
+    if( test_top >= rules.fieldH ) {
+        result = paddleY;
+    } else if( test_bottom <= -rules.fieldH ) {
+        result = paddleY;
+    }
+    return result;
+}
+
+inline f32 PlayerDY(const PlayerInput& input) {
+    if(input.up) { return 1.0f; }
+    else if(input.down) { return -1.0f; }
+    return 0.0f;
+}
+
+// Where the ball will cross the cpu paddle. Bounces off the ceiling and floor
+// are mirror images, so the ball travels in a straight line through mirrored
+// copies of the field and its real height is that line folded back into the
+// field. Folding repeats every 4 ranges (up, down, down, up), the table holds one
+// period of a field one unit high so a lookup is a multiply and a mask instead of
+// a loop over bounces, and scaling by the range fits it to the ball's size.
+// Bins are centered on their heights, so a ball flying flat down the middle is
+// in the middle of a bin and float rounding can't flip it to either side.
+const u32 INTERCEPT_BINS   = 1024; // power of two, bins wrap with a mask
+// keeps steep lines in range of the int conversion
+const f32 INTERCEPT_LIMIT  = 65536.0f;
+
+struct InterceptTable { f32 y[INTERCEPT_BINS]; };
+
+constexpr InterceptTable BuildInterceptTable() {
+    InterceptTable result = {};
+    for( u32 bin = 0; bin < INTERCEPT_BINS; bin++ ) {
+        // height above the floor, going up then back down
+        f32 height = (f32)bin * 4.0f / INTERCEPT_BINS;
+        if( height > 2.0f ) { height = 4.0f - height; }
+        result.y[bin] = height - 1.0f;
+    }
+    return result;
+}
+inline constexpr InterceptTable INTERCEPT_TABLE = BuildInterceptTable();
+
+// highest the ball's center goes
+template<typename Real>
+constexpr Real InterceptRange( const BasicGameRules<Real>& rules ) { return rules.fieldH - rules.BallHalfSize(); }
+template<typename Real>
+constexpr Real InterceptScale( const BasicGameRules<Real>& rules ) { return (f32)INTERCEPT_BINS / (4.0f * InterceptRange(rules)); }
+// added to the height before the lookup, a range to start at the floor and half a bin to round
+template<typename Real>
+constexpr Real InterceptOffset( const BasicGameRules<Real>& rules ) { return InterceptRange(rules) + 0.5f / InterceptScale(rules); }
+// where the ball's center is when it touches the cpu paddle
+template<typename Real>
+constexpr Real CpuInterceptX( const BasicGameRules<Real>& rules )  { return rules.paddleX - rules.PaddleHalfW() - rules.BallHalfSize(); }
+// how far off the intercept the cpu is happy to be, half the middle third so
+// the ball lands well inside it and not on the edge of a steep third
+template<typename Real>
+constexpr Real CpuAimSlack( const BasicGameRules<Real>& rules )    { return rules.PaddleThirdH() / 4.0f; }
+
+// height of the ball when it reaches the cpu paddle, dirX must be positive
+template<typename Real>
+inline Real InterceptY(Real ballX, Real ballY, Real dirX, Real dirY, const BasicGameRules<Real>& rules = DEFAULT_RULES) {
+    Real range    = InterceptRange(rules);
+    Real unfolded = ballY + dirY / dirX * (CpuInterceptX(rules) - ballX) + InterceptOffset(rules);
+    unfolded = Min( Max(unfolded, (Real)-INTERCEPT_LIMIT), (Real)INTERCEPT_LIMIT );
+    i32 bin  = FloorToInt(unfolded * InterceptScale(rules)) & (i32)(INTERCEPT_BINS - 1);
+    return INTERCEPT_TABLE.y[bin] * range;
+}
+
+// whether the cpu is going for the ball, see cpuAimX in rules.hpp
+template<typename Real>
+inline bool CpuAiming(Real ballX, Real dirX, const BasicGameRules<Real>& rules = DEFAULT_RULES) {
+    return dirX > 0.0f && ballX > rules.cpuAimX;
+}
+
+// heads for where the ball is going to be once it's close enough,
+// back to the middle until then and while it's going away
+template<typename Real>
+inline Real CpuDY(Real ballX, Real ballY, Real dirX, Real dirY, Real cpuY, const BasicGameRules<Real>& rules = DEFAULT_RULES) {
+    Real target = CpuAiming(ballX, dirX, rules) ? InterceptY(ballX, ballY, dirX, dirY, rules) : (Real)0.0f;
+    if( target > cpuY + CpuAimSlack(rules) ) {
+        return rules.cpuSpeed;
+    } else if( target < cpuY - CpuAimSlack(rules) ) {
+        return -rules.cpuSpeed;
+    } else { return 0.0f; }
+}
+
+// simple chasing AI for the left paddle, used when no human is playing
+template<typename Real>
+inline PlayerInput BotInput(Real ballX, Real ballY, Real playerY, const BasicGameRules<Real>& rules = DEFAULT_RULES) {
+    PlayerInput result = {};
+    if( ballX > -CPU_REACT_X ) { return result; }
+    result.up   = ballY > playerY + rules.PaddleHalfH();
+    result.down = ballY < playerY - rules.PaddleHalfH();
+    return result;
+}
+
+// direction of a bounce off the middle third of a paddle,
+// depends only on the match's key and the tick it happens on
+inline f32 MiddleBounce(u64 rngKey, u32 tick) {
+    return (Squares32(tick, rngKey) & 1) == 0 ? 0.05f : -0.05f;
+}
+
+template<typename Match>
+inline void ResetBall(const Match& match) {
+    match.ballX = 0.0f;
+    match.ballY = 0.0f;
+    match.dirX  = -match.dirX;
+    match.dirY  = 0.0f;
+}
+
+template<typename Match>
+inline void MoveBallX(const Match& match, typename Match::Real delta) {
+    using Real = typename Match::Real;
+    Real result = match.ballX + delta;
+    Real test_left  = result - match.rules.BallHalfSize();
+    Real test_right = result + match.rules.BallHalfSize();
+
+    bool out_left  = test_right <= -match.rules.fieldW;
+    bool out_right = test_left >= match.rules.fieldW;
+
+    // out of bounds
+    if( out_left || out_right ) {
+
+        match.scored = true;
+
+        if(out_left) {
+            match.cpuScore++;
+        } else if(out_right) {
+            match.playerScore++;
+        }
+        return;
+    }
+
+    match.ballX = result;
+}
+
+template<typename Match>
+inline void MoveBallY(const Match& match, typename Match::Real delta) {
+    using Real = typename Match::Real;
+    Real result = match.ballY + delta;
+    Real test_top    = result + match.rules.BallHalfSize();
+    Real test_bottom = result - match.rules.BallHalfSize();
+
+    // collision with ceiling/floor
+    if( test_top >= match.rules.fieldH ) {
+        match.dirY = Abs(match.dirY) * -1.0f;
+        return;
+    } else if( test_bottom <= -match.rules.fieldH ) {
+        match.dirY = Abs(match.dirY);
+        return;
+    }
+
+    match.ballY = result;
+}
+
+// sends the ball back towards dirX, the part of the paddle it hit sets the angle
+template<typename Match>
+inline void PaddleBounce(const Match& match, typename Match::Real paddleY, f32 dirX) {
+    using Real = typename Match::Real;
+    match.dirX = dirX;
+    // ball is in the top third of the paddle
+    if( match.ballY > paddleY + match.rules.PaddleThirdH() / 2.0f ) {
+        match.dirY = match.rules.bounceMax;
+    // ball is in the bottom third of the paddle
+    } else if( match.ballY < paddleY - match.rules.PaddleThirdH() / 2.0f ) {
+        match.dirY = -match.rules.bounceMax;
+    // ball is in the middle of the paddle
+    } else {
+        match.dirY = MiddleBounce(match.rngKey, match.tick);
+    }
+
+    // normalize direction
+    Real invLength = 1.0f / Sqrt( match.dirX * match.dirX + match.dirY * match.dirY );
+    match.dirX *= invLength;
+    match.dirY *= invLength;
+}
+
+template<typename Match>
+inline void BallCollision(const Match& match) {
+    using Real = typename Match::Real;
+    const BasicGameRules<Real>& rules = match.rules;
+    Real ballHalf   = rules.BallHalfSize();
+    Real paddleHalf = rules.PaddleHalfH();
+    Real left   = match.ballX - ballHalf;
+    Real right  = match.ballX + ballHalf;
+    Real top    = match.ballY + ballHalf;
+    Real bottom = match.ballY - ballHalf;
+
+    Real player_left   = -rules.paddleX - rules.PaddleHalfW();
+    Real player_right  = -rules.paddleX + rules.PaddleHalfW();
+    Real player_top    = match.playerY + paddleHalf;
+    Real player_bottom = match.playerY - paddleHalf;
+
+    Real cpu_left   = rules.paddleX - rules.PaddleHalfW();
+    Real cpu_right  = rules.paddleX + rules.PaddleHalfW();
+    Real cpu_top    = match.cpuY + paddleHalf;
+    Real cpu_bottom = match.cpuY - paddleHalf;
+
+    // within player
+    bool hit_player = bottom <= player_top && top >= player_bottom &&
+                      left <= player_right && right >= player_left;
+    // within cpu
+    bool hit_cpu    = bottom <= cpu_top && top >= cpu_bottom &&
+                      left <= cpu_right && right >= cpu_left;
+
+    if(hit_cpu) {
+        PaddleBounce(match, match.cpuY, -1.0f);
+    } else if(hit_player) {
+        PaddleBounce(match, match.playerY, 1.0f);
+    }
+}
+
+// counts down the pause after a point and serves the next ball
+template<typename Match>
+inline void WaitForRound(const Match& match, DeltaTime ts) {
+    match.scoreTimer += ts;
+    if(match.scoreTimer >= match.rules.delayBetweenRounds) {
+        match.scoreTimer = 0.0f;
+        match.scored = false;
+        ResetBall(match);
+    }
+}
+
+// moves the ball, or waits out the pause after a point
+template<typename Match>
+inline void StepBall( const Match& match, DeltaTime ts ) {
+    if( !match.scored ) {
+        MoveBallX(match, match.dirX * ts * match.rules.ballSpeed);
+        MoveBallY(match, match.dirY * ts * match.rules.ballSpeed);
+        BallCollision(match);
+    } else {
+        WaitForRound(match, ts);
+    }
+}
+
+// Advances a match that is in game by ts seconds.
+template<typename Match>
+inline void StepMatch( const Match& match, DeltaTime ts, const PlayerInput& input ) {
+    using Real = typename Match::Real;
+    StepBall(match, ts);
+    Real playerDelta = match.rules.paddleSpeed * PlayerDY(input) * ts;
+    Real cpuDelta    = CpuDY(match.ballX, match.ballY, match.dirX, match.dirY, match.cpuY, match.rules) * ts;
+    match.playerY = MovePaddle( match.playerY, playerDelta, match.rules );
+    match.cpuY    = MovePaddle( match.cpuY,    cpuDelta,    match.rules );
+    match.tick++;
+}
+
+// StepMatch with the right paddle played from cpuInput instead of CpuDY
+template<typename Match>
+inline void StepMatchVersus( const Match& match, DeltaTime ts, const PlayerInput& input, const PlayerInput& cpuInput ) {
+    using Real = typename Match::Real;
+    StepBall(match, ts);
+    Real playerDelta = match.rules.paddleSpeed * PlayerDY(input) * ts;
+    Real cpuDelta    = match.rules.paddleSpeed * PlayerDY(cpuInput) * ts;
+    match.playerY = MovePaddle( match.playerY, playerDelta, match.rules );
+    match.cpuY    = MovePaddle( match.cpuY,    cpuDelta,    match.rules );
+    match.tick++;
+}
@@ -0,0 +1,118 @@
+#include "profile.hpp"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// rings are never freed, a trace can still be written after their thread ends
+std::atomic<ProfileRing*> g_profileRings[PROFILE_MAX_THREADS];
+std::atomic<u32> g_profileRingCount{0};
+thread_local ProfileRing* t_profileRing = nullptr;
+thread_local bool t_profileRingFull     = false;
+
+u64 ProfileNow() {
+    static const std::chrono::steady_clock::time_point START = std::chrono::steady_clock::now();
+    return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - START
+    ).count();
+}
+
+ProfileRing* ThreadProfileRing() {
+    if( t_profileRing || t_profileRingFull ) { return t_profileRing; }
+    u32 index = g_profileRingCount.load(std::memory_order_relaxed);
+    do {
+        if( index >= PROFILE_MAX_THREADS ) {
+            t_profileRingFull = true;
+            return nullptr;
+        }
+    } while( !g_profileRingCount.compare_exchange_weak(index, index + 1, std::memory_order_relaxed) );
+
+    ProfileRing* ring = new ProfileRing();
+    ring->threadId = index + 1;
+    g_profileRings[index].store(ring, std::memory_order_release);
+    t_profileRing = ring;
+    return ring;
+}
+
+void RecordProfileEvent( const char* name, u64 start, u64 end ) {
+    ProfileRing* ring = ThreadProfileRing();
+    if( !ring ) { return; }
+    // only this thread writes head, the trace writer reads it
+    u64 head = ring->head.load(std::memory_order_relaxed);
+    ProfileEvent& event = ring->events[head & (PROFILE_RING_EVENTS - 1)];
+    event.name  = name;
+    event.start = start;
+    event.end   = end;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void SetProfileThreadName( const char* name ) {
+    ProfileRing* ring = ThreadProfileRing();
+    if( ring ) { ring->threadName.store(name, std::memory_order_release); }
+}
+
+// copies out the zones of a ring that weren't overwritten while copying
+void CopyProfileRing( ProfileRing& ring, std::vector<ProfileEvent>& events ) {
+    u64 head  = ring.head.load(std::memory_order_acquire);
+    u64 first = head > PROFILE_RING_EVENTS ? head - PROFILE_RING_EVENTS : 0;
+    events.clear();
+    for( u64 i = first; i < head; i++ ) {
+        events.push_back( ring.events[i & (PROFILE_RING_EVENTS - 1)] );
+    }
+    // slots the writer got to since, and the one it may be writing now,
+    // can be torn, drop them from the front
+    std::atomic_thread_fence(std::memory_order_acquire);
+    u64 after = ring.head.load(std::memory_order_relaxed) + 1;
+    u64 safeFirst = after > PROFILE_RING_EVENTS ? after - PROFILE_RING_EVENTS : 0;
+    if( safeFirst > first ) {
+        u64 torn = safeFirst - first < events.size() ? safeFirst - first : events.size();
+        events.erase( events.begin(), events.begin() + torn );
+    }
+}
+
+// names are written as they are, escape the characters json needs escaped
+void WriteJsonString( FILE* out, const char* text ) {
+    fputc('"', out);
+    for( const char* c = text; *c; c++ ) {
+        if( *c == '"' || *c == '\\' ) { fputc('\\', out); }
+        if( (u8)*c < 0x20 ) { fprintf(out, "\\u%04x", (u32)(u8)*c); continue; }
+        fputc(*c, out);
+    }
+    fputc('"', out);
+}
+
+bool WriteChromeTrace( const char* path ) {
+    FILE* out = fopen( path, "w" );
+    if( !out ) { return false; }
+
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    std::vector<ProfileEvent> events;
+    u32 count = g_profileRingCount.load(std::memory_order_acquire);
+    for( u32 index = 0; index < count; index++ ) {
+        ProfileRing* ring = g_profileRings[index].load(std::memory_order_acquire);
+        // counted but not published yet
+        if( !ring ) { continue; }
+
+        const char* threadName = ring->threadName.load(std::memory_order_acquire);
+        if( threadName ) {
+            fprintf(out, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                first ? "" : ",\n", ring->threadId);
+            WriteJsonString( out, threadName );
+            fprintf(out, "}}");
+            first = false;
+        }
+
+        CopyProfileRing( *ring, events );
+        for( const ProfileEvent& event : events ) {
+            // complete events, microseconds with the nanoseconds kept as a fraction
+            fprintf(out, "%s{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+                first ? "" : ",\n", ring->threadId,
+                event.start / 1000.0, (event.end - event.start) / 1000.0);
+            WriteJsonString( out, event.name );
+            fputc('}', out);
+            first = false;
+        }
+    }
+    fprintf(out, "\n]}\n");
+    return fclose( out ) == 0;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "defines.hpp"
+#include <atomic>
+
+// Scoped timer zones for finding where frame time goes.
+// Build with -D PROFILE to record them, without it PROFILE_ZONE and
+// PROFILE_THREAD_NAME compile to nothing. Every thread writes its zones to its
+// own ring buffer without locks, WriteChromeTrace saves what the rings hold
+// as a trace that chrome://tracing and ui.perfetto.dev can open.
+
+// zones kept per thread, older ones are overwritten, a power of two
+const u32 PROFILE_RING_EVENTS = 1 << 16;
+// threads that can record zones, the ones after that are ignored
+const u32 PROFILE_MAX_THREADS = 64;
+
+struct ProfileEvent {
+    // must outlive the trace, string literals are
+    const char* name;
+    // nanoseconds since the first zone of the program
+    u64 start;
+    u64 end;
+};
+
+struct ProfileRing {
+    // zones ever written, the next one goes to head % PROFILE_RING_EVENTS
+    std::atomic<u64> head{0};
+    u32 threadId;
+    std::atomic<const char*> threadName{nullptr};
+    ProfileEvent events[PROFILE_RING_EVENTS];
+};
+
+u64 ProfileNow();
+// the calling thread's ring, nullptr once every ring is taken
+ProfileRing* ThreadProfileRing();
+void RecordProfileEvent( const char* name, u64 start, u64 end );
+// shown instead of the thread's number in the trace
+void SetProfileThreadName( const char* name );
+
+// Writes every zone still in the rings to path, returns false if it can't be
+// written. Threads can keep recording meanwhile, zones overwritten while
+// they're being copied are left out.
+bool WriteChromeTrace( const char* path );
+
+class ProfileZone {
+public:
+    ProfileZone( const char* name ) : m_name(name), m_start(ProfileNow()) {}
+    ~ProfileZone() { RecordProfileEvent( m_name, m_start, ProfileNow() ); }
+    ProfileZone( const ProfileZone& ) = delete;
+    ProfileZone& operator=( const ProfileZone& ) = delete;
+private:
+    const char* m_name;
+    u64 m_start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef PROFILE
+// times from here to the end of the enclosing scope
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_THREAD_NAME(name) SetProfileThreadName(name)
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_THREAD_NAME(name)
+#endif
@@ -0,0 +1,67 @@
+#include "rendercommands.hpp"
+#include <algorithm>
+
+bool PushRenderCommand( RenderCommandBuffer& buffer, u64 key, const void* data, u32 count, const glm::vec3& color ) {
+    if( buffer.count == MAX_RENDER_COMMANDS ) {
+        buffer.dropped++;
+        return false;
+    }
+    RenderCommand& command = buffer.commands[buffer.count];
+    command.key   = key | buffer.count;
+    command.data  = data;
+    command.count = count;
+    command.color = color;
+    buffer.count++;
+    return true;
+}
+
+void SortRenderCommands( RenderCommandBuffer& buffer ) {
+    std::sort( buffer.commands, buffer.commands + buffer.count,
+        []( const RenderCommand& a, const RenderCommand& b ) { return a.key < b.key; } );
+}
+
+u32 RenderRunEnd( const RenderCommandBuffer& buffer, u32 first ) {
+    u32 state = RenderKeyState( buffer.commands[first].key );
+    u32 end = first + 1;
+    while( end < buffer.count && RenderKeyState( buffer.commands[end].key ) == state ) { end++; }
+    return end;
+}
+
+u32 GatherRects( const RenderCommandBuffer& buffer, RenderCursor& cursor, u32 end, RectInstance* out, u32 max ) {
+    u32 result = 0;
+    while( cursor.command < end && result < max ) {
+        const RenderCommand& command = buffer.commands[cursor.command];
+        u32 count = std::min( command.count - cursor.offset, max - result );
+        std::copy_n( (const RectInstance*)command.data + cursor.offset, count, out + result );
+        result += count;
+        cursor.offset += count;
+        if( cursor.offset == command.count ) {
+            cursor.command++;
+            cursor.offset = 0;
+        }
+    }
+    return result;
+}
+
+u32 GatherText(
+    const RenderCommandBuffer& buffer, RenderCursor& cursor, u32 end,
+    const FontAtlas& atlas, TextVertex* out, u32 maxGlyphs
+) {
+    u32 glyphs   = 0;
+    u32 vertices = 0;
+    while( cursor.command < end && glyphs < maxGlyphs ) {
+        const RenderCommand& command = buffer.commands[cursor.command];
+        u32 count = std::min( command.count - cursor.offset, maxGlyphs - glyphs );
+        vertices += WriteTextVertices(
+            atlas, (const TextQuad*)command.data + cursor.offset, count,
+            command.color, out + vertices
+        );
+        glyphs += count;
+        cursor.offset += count;
+        if( cursor.offset == command.count ) {
+            cursor.command++;
+            cursor.offset = 0;
+        }
+    }
+    return vertices;
+}
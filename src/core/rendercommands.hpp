@@ -0,0 +1,94 @@
+#pragma once
+#include "defines.hpp"
+#include "arena.hpp"
+#include "atlas.hpp"
+#include <glm/vec3.hpp>
+
+// Drawing is recorded as commands during the frame and handed to the backend
+// at the end of it. Every command has a sort key with the state it draws with
+// in the high bits, so sorting puts everything drawn with the same state next
+// to each other and the backend sets each state once and draws each run in as
+// few calls as fit. Recording doesn't touch any graphics api.
+
+// what draws on top of what, before any state
+enum class RenderLayer : u8 {
+    GAME,
+    UI,
+};
+// shader and vertex layout
+enum class RenderPipeline : u8 {
+    RECTS,
+    TEXT,
+};
+enum class RenderTexture : u8 {
+    NONE,
+    FONT_ATLAS,
+};
+enum class RenderBlend : u8 {
+    NONE,
+    ALPHA,
+};
+
+// bits from high to low: layer 8, pipeline 8, texture 8, blend 8, then 32 bits
+// of recording order so within a state things draw in the order they came in.
+// there's no depth, the layer is the only thing that puts one draw over another
+const u32 RENDER_KEY_STATE_SHIFT = 32;
+
+constexpr u64 MakeRenderKey( RenderLayer layer, RenderPipeline pipeline, RenderTexture texture, RenderBlend blend ) {
+    u64 state = ((u64)layer << 24) | ((u64)pipeline << 16) | ((u64)texture << 8) | (u64)blend;
+    return state << RENDER_KEY_STATE_SHIFT;
+}
+// the layer and the state, commands with the same value draw as one run
+inline u32 RenderKeyState( u64 key ) { return (u32)(key >> RENDER_KEY_STATE_SHIFT); }
+inline RenderPipeline RenderKeyPipeline( u64 key ) { return (RenderPipeline)((key >> 48) & 0xFF); }
+inline RenderTexture RenderKeyTexture( u64 key ) { return (RenderTexture)((key >> 40) & 0xFF); }
+inline RenderBlend RenderKeyBlend( u64 key ) { return (RenderBlend)((key >> 32) & 0xFF); }
+
+struct RenderCommand {
+    u64 key;
+    // RectInstance for RECTS, TextQuad for TEXT, in the frame arena
+    const void* data;
+    u32 count;
+    // TEXT only
+    glm::vec3 color;
+};
+
+// a rectangle in field units, x and y are its center
+struct RectInstance {
+    f32 x; f32 y;
+    f32 w; f32 h;
+};
+
+// how the game draws its rectangles and text
+constexpr u64 RECTS_KEY = MakeRenderKey( RenderLayer::GAME, RenderPipeline::RECTS, RenderTexture::NONE, RenderBlend::NONE );
+constexpr u64 TEXT_KEY  = MakeRenderKey( RenderLayer::UI, RenderPipeline::TEXT, RenderTexture::FONT_ATLAS, RenderBlend::ALPHA );
+
+// the recording order bits count up to this
+const u32 MAX_RENDER_COMMANDS = 1024;
+
+struct RenderCommandBuffer {
+    RenderCommand commands[MAX_RENDER_COMMANDS];
+    u32 count;
+    // commands that came in with the buffer full, they're left out of their frame
+    u64 dropped;
+};
+
+// false when the buffer is full, the command is counted in dropped instead
+bool PushRenderCommand( RenderCommandBuffer& buffer, u64 key, const void* data, u32 count, const glm::vec3& color = glm::vec3(1.0f) );
+void SortRenderCommands( RenderCommandBuffer& buffer );
+// one past the last command after first with the same RenderKeyState
+u32 RenderRunEnd( const RenderCommandBuffer& buffer, u32 first );
+
+// Where a backend is in a run of commands it's copying out in pieces.
+struct RenderCursor {
+    u32 command;
+    u32 offset;
+};
+
+// copy up to max rects from the run [cursor, end) into out, returns how many
+u32 GatherRects( const RenderCommandBuffer& buffer, RenderCursor& cursor, u32 end, RectInstance* out, u32 max );
+// writes up to maxGlyphs glyphs of the run [cursor, end) into out, returns how many vertices
+u32 GatherText(
+    const RenderCommandBuffer& buffer, RenderCursor& cursor, u32 end,
+    const FontAtlas& atlas, TextVertex* out, u32 maxGlyphs
+);
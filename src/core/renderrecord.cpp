@@ -0,0 +1,91 @@
+#include "renderrecord.hpp"
+#include "arena.hpp"
+#include <cstring>
+
+RenderCommandBuffer renderCommands;
+TextMetrics textMetrics;
+bool fontLoaded = false;
+
+RenderCommandBuffer& RecordedRenderCommands() { return renderCommands; }
+
+void SetRecordTextMetrics(const TextMetrics& metrics) {
+    textMetrics = metrics;
+    fontLoaded  = true;
+}
+
+void RenderScore(u32 playerScore, u32 cpuScore) {
+    f32 textX = 200.0f;
+    f32 textY = SCREEN_H - 125.0f;
+    RenderText(FormatU32(FrameArena(), playerScore), textX, textY, TEXT_SCALE);
+    RenderText(FormatU32(FrameArena(), cpuScore), SCREEN_W - textX, textY, TEXT_SCALE, UITextStyle::REVERSE, glm::vec3(1.0f));
+}
+
+void RenderGame(const GameState& gameState) {
+    if( gameState.scored ) {
+        RenderScore(gameState.playerScore, gameState.cpuScore);
+    }
+
+    RectInstance rects[3];
+    u32 count = 0;
+    if(!gameState.scored) {
+        rects[count++] = { gameState.ball.x, gameState.ball.y, BALL_SIZE, BALL_SIZE };
+    }
+    rects[count++] = { -PADDLE_X_POS, gameState.player.y, PADDLE_W, PADDLE_H };
+    rects[count++] = {  PADDLE_X_POS, gameState.cpu.y,    PADDLE_W, PADDLE_H };
+    RenderRects(rects, count);
+}
+
+void RenderRects(const RectInstance* rects, u32 count) {
+    if( count == 0 ) { return; }
+    RectInstance* recorded = ArenaPushArray<RectInstance>( FrameArena(), count );
+    if( !recorded ) { return; }
+    memcpy(recorded, rects, sizeof(RectInstance) * count);
+    PushRenderCommand(renderCommands, RECTS_KEY, recorded, count, glm::vec3(1.0f));
+}
+
+void RenderMenu(const MenuOption& currentMenuOption) {
+    switch(currentMenuOption) {
+        case MenuOption::START_GAME: {
+            GetStartGameText().color = SELECT_COLOR;
+            GetQuitGameText().color  = DESELECT_COLOR;
+        } break;
+        case MenuOption::QUIT_GAME: {
+            GetStartGameText().color = DESELECT_COLOR;
+            GetQuitGameText().color  = SELECT_COLOR;
+        } break;
+    }
+    RenderText( GetTitleText() );
+    RenderText( GetStartGameText() );
+    RenderText( GetQuitGameText() );
+    RenderText( GetControlsText0() );
+    RenderText( GetControlsText1() );
+    RenderText( GetControlsText2() );
+}
+
+void RenderText(std::string_view text, f32 x, f32 y, f32 scale, UITextStyle textStyle, const glm::vec3& color) {
+    if(!fontLoaded) { return; }
+
+    // the frame arena is only out of room if something leaks into it every frame
+    TextQuad* quads = ArenaPushArray<TextQuad>( FrameArena(), text.size() );
+    if( !quads ) { return; }
+    u32 count = LayoutText( textMetrics, text, x, y, scale, textStyle, quads, (u32)text.size() );
+    if( count == 0 ) { return; }
+    // the quads stay in the frame arena until the command is submitted
+    PushRenderCommand(renderCommands, TEXT_KEY, quads, count, color);
+}
+void RenderText(std::string_view text, f32 x, f32 y, f32 scale, UITextStyle textStyle) {
+    RenderText(text, x, y, scale, textStyle, glm::vec3(1.0f));
+}
+void RenderText(std::string_view text, f32 x, f32 y, f32 scale) {
+    RenderText(text, x, y, scale, UITextStyle::NORMAL);
+}
+void RenderText(const UITextElement& textElement) {
+    RenderText(
+        textElement.text,
+        textElement.xPos,
+        textElement.yPos,
+        textElement.scale,
+        textElement.style,
+        textElement.color
+    );
+}
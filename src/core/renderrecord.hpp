@@ -0,0 +1,28 @@
+#pragma once
+#include "defines.hpp"
+#include "app.hpp"
+#include "text.hpp"
+#include "ui.hpp"
+#include "rendercommands.hpp"
+#include <glm/vec3.hpp>
+#include <string_view>
+
+// The half of the renderer every backend shares. Render calls lay out what
+// they draw and record it into one RenderCommandBuffer, nothing here touches
+// a graphics api. The backend sorts and draws the buffer in RendererEndFrame,
+// so recording never has to happen on the thread that owns the gpu.
+
+void RenderMenu(const MenuOption& currentMenuOption);
+void RenderGame(const GameState& gameState);
+// any number of white rectangles, rects only has to live until the call returns
+void RenderRects(const RectInstance* rects, u32 count);
+// text only has to live until the call returns
+void RenderText(std::string_view text, f32 x, f32 y, f32 scale, UITextStyle textStyle, const glm::vec3& color);
+void RenderText(std::string_view text, f32 x, f32 y, f32 scale, UITextStyle textStyle);
+void RenderText(std::string_view text, f32 x, f32 y, f32 scale);
+void RenderText(const UITextElement& textElement);
+
+// everything recorded since the backend last submitted
+RenderCommandBuffer& RecordedRenderCommands();
+// text is skipped until the backend has loaded a font and set its metrics
+void SetRecordTextMetrics(const TextMetrics& metrics);
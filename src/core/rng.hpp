@@ -0,0 +1,27 @@
+#pragma once
+#include "defines.hpp"
+
+const u64 DEFAULT_RNG_SEED = 0x5eed5eed5eed5eedull;
+
+// Counter based generator (Widynski's Squares).
+// A draw is a pure function of key and counter, there is no state to
+// share between matches or threads, so any match can be stepped anywhere.
+inline u32 Squares32( u64 counter, u64 key ) {
+    u64 x = counter * key;
+    u64 y = x;
+    u64 z = y + key;
+    x = x * x + y; x = (x >> 32) | (x << 32);
+    x = x * x + z; x = (x >> 32) | (x << 32);
+    x = x * x + y; x = (x >> 32) | (x << 32);
+    return (u32)((x * x + z) >> 32);
+}
+
+// splitmix64 of seed and match id, squares wants keys with well mixed bits
+inline u64 MatchRngKey( u64 seed, u32 matchId ) {
+    u64 z = seed + 0x9e3779b97f4a7c15ull * ((u64)matchId + 1);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z = z ^ (z >> 31);
+    // odd keys keep counter * key a bijection
+    return z | 1;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "globals.hpp"
+#include "fixed.hpp"
+
+constexpr f32 DELAY_BETWEEN_ROUNDS = 1.5f;
+constexpr f32 BALL_SPEED   = 1.25f;
+constexpr f32 PADDLE_SPEED = 1.15f;
+constexpr f32 BOUNCE_MAX = 0.6f;
+constexpr f32 CPU_REACT_X = 0.65f;
+// how close the cpu lets the ball get before going for it, and how fast it goes.
+// Slower than the player's paddle, so a steep enough shot gets past it
+constexpr f32 CPU_AIM_X = 0.8f;
+constexpr f32 CPU_SPEED = 0.8f;
+
+// The gameplay constants that can change without touching the step code.
+// The game plays with DEFAULT_RULES, sweeps and experiments make their own.
+// Real is the type the values and everything worked out from them are in,
+// the same type as the match state they're used with.
+template<typename Real>
+struct BasicGameRules {
+    Real ballSpeed          = BALL_SPEED;
+    Real paddleSpeed        = PADDLE_SPEED;
+    Real bounceMax          = BOUNCE_MAX;
+    Real delayBetweenRounds = DELAY_BETWEEN_ROUNDS;
+    Real ballSize           = BALL_SIZE;
+    Real paddleW            = PADDLE_W;
+    Real paddleH            = PADDLE_H;
+    // distance from the middle to a paddle's center
+    Real paddleX            = PADDLE_X_POS;
+    // half the field's width and height
+    Real fieldW             = FIELD_W;
+    Real fieldH             = FIELD_H;
+    // the cpu's difficulty: it waits in the middle until the ball coming its way
+    // is past cpuAimX, then heads for it at cpuSpeed. Lower cpuAimX gives it
+    // longer to get there, PADDLE_SPEED and -fieldW make it unbeatable
+    Real cpuAimX            = CPU_AIM_X;
+    Real cpuSpeed           = CPU_SPEED;
+
+    constexpr Real BallHalfSize() const { return ballSize / 2.0f; }
+    constexpr Real PaddleHalfW() const  { return paddleW / 2.0f; }
+    constexpr Real PaddleHalfH() const  { return paddleH / 2.0f; }
+    constexpr Real PaddleThirdH() const { return paddleH / 3.0f; }
+};
+using GameRules = BasicGameRules<f32>;
+inline constexpr GameRules DEFAULT_RULES = {};
+
+// the same rules in another Real
+template<typename Real>
+constexpr BasicGameRules<Real> ConvertRules( const GameRules& rules ) {
+    BasicGameRules<Real> result = {};
+    result.ballSpeed          = rules.ballSpeed;
+    result.paddleSpeed        = rules.paddleSpeed;
+    result.bounceMax          = rules.bounceMax;
+    result.delayBetweenRounds = rules.delayBetweenRounds;
+    result.ballSize           = rules.ballSize;
+    result.paddleW            = rules.paddleW;
+    result.paddleH            = rules.paddleH;
+    result.paddleX            = rules.paddleX;
+    result.fieldW             = rules.fieldW;
+    result.fieldH             = rules.fieldH;
+    result.cpuAimX            = rules.cpuAimX;
+    result.cpuSpeed           = rules.cpuSpeed;
+    return result;
+}
+
+// Rule sets for BasicPong. Every set gets its own copy of the step code with
+// VALUES folded into it, Real is the type match state is kept and stepped in.
+struct ClassicRules {
+    using Real = f32;
+    static constexpr GameRules VALUES = DEFAULT_RULES;
+};
+
+// same game in double precision, for measuring float drift
+struct PreciseRules {
+    using Real = f64;
+    static constexpr BasicGameRules<f64> VALUES = ConvertRules<f64>(DEFAULT_RULES);
+};
+
+// same game in Q16.16 fixed point, plays out bit for bit the same on any build
+struct FixedPointRules {
+    using Real = Fixed;
+    static constexpr BasicGameRules<Fixed> VALUES = ConvertRules<Fixed>(DEFAULT_RULES);
+};
+
+constexpr GameRules FastRulesValues() {
+    GameRules result = {};
+    result.ballSpeed   = BALL_SPEED * 2.0f;
+    result.delayBetweenRounds = 0.5f;
+    result.fieldW  = FIELD_H * 4.0f / 3.0f;
+    result.paddleX = result.fieldW * 0.8f;
+    return result;
+}
+
+// twice the ball speed on a 4:3 field
+struct FastRules {
+    using Real = f32;
+    static constexpr GameRules VALUES = FastRulesValues();
+};
+
+// read from memory every tick, for trying values without rebuilding
+struct TunableRules {
+    using Real = f32;
+    static inline GameRules VALUES = DEFAULT_RULES;
+};
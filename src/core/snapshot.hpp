@@ -0,0 +1,82 @@
+#pragma once
+#include "app.hpp"
+
+// Snapshots of the last N game ticks, for rollback and rewinding.
+// Game is any BasicPong, storage is part of the ring itself, recording never allocates.
+template<typename Game, u32 N>
+class SnapshotRing {
+public:
+    using Snapshot = typename Game::Snapshot;
+
+    SnapshotRing() { Clear(); }
+
+    void Clear() {
+        for( u32 i = 0; i < N; i++ ) { m_valid[i] = false; }
+        m_newest = 0;
+        m_count  = 0;
+    }
+
+    // saves game under its current tick, overwriting whatever was N ticks ago.
+    // anything newer than that tick belongs to an abandoned future and is dropped
+    void Record( const Game& game ) {
+        u32 tick = game.CurrentTick();
+        DropAfter( tick );
+        u32 slot = tick % N;
+        if( !m_valid[slot] ) { m_count++; }
+        game.SaveSnapshot( m_snapshots[slot] );
+        m_valid[slot] = true;
+        m_newest = tick;
+    }
+
+    bool Has( u32 tick ) const {
+        u32 slot = tick % N;
+        return m_valid[slot] && m_snapshots[slot].tick == tick;
+    }
+
+    // puts game back to how it was at tick and drops every snapshot after it,
+    // false if that tick is no longer kept
+    bool Restore( Game& game, u32 tick ) {
+        if( !Has(tick) ) { return false; }
+        game.RestoreSnapshot( m_snapshots[tick % N] );
+        DropAfter( tick );
+        m_newest = tick;
+        return true;
+    }
+
+    // goes back ticks ticks from the newest snapshot
+    bool Rewind( Game& game, u32 ticks ) {
+        if( m_count == 0 || ticks > m_newest ) { return false; }
+        return Restore( game, m_newest - ticks );
+    }
+
+    const Snapshot* Get( u32 tick ) const {
+        return Has(tick) ? &m_snapshots[tick % N] : nullptr;
+    }
+
+    u32 Newest() const { return m_newest; }
+    // snapshots currently kept
+    u32 Count() const { return m_count; }
+    static u32 Capacity() { return N; }
+private:
+    // at most N slots can hold a tick newer than tick
+    void DropAfter( u32 tick ) {
+        if( m_count == 0 || m_newest <= tick ) { return; }
+        u32 span = m_newest - tick;
+        if( span > N ) { span = N; }
+        for( u32 i = 1; i <= span; i++ ) {
+            u32 newer = m_newest - (span - i);
+            u32 slot  = newer % N;
+            if( m_valid[slot] && m_snapshots[slot].tick == newer ) {
+                m_valid[slot] = false;
+                m_count--;
+            }
+        }
+    }
+
+    Snapshot m_snapshots[N];
+    bool m_valid[N];
+    u32 m_newest;
+    u32 m_count;
+};
+
+template<u32 N> using PongSnapshotRing = SnapshotRing<Pong, N>;
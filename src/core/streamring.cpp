@@ -0,0 +1,39 @@
+#include "streamring.hpp"
+
+StreamRing CreateStreamRing( void* memory, size_t regionSize ) {
+    StreamRing result = {};
+    result.memory     = (u8*)memory;
+    result.regionSize = regionSize;
+    result.region     = 0;
+    result.used       = 0;
+    return result;
+}
+
+StreamSpan StreamRingPush( StreamRing& ring, size_t stride, size_t count ) {
+    StreamSpan result = {};
+    size_t regionStart = ring.region * ring.regionSize;
+    // strides like 28 aren't powers of two, round up with a divide
+    size_t start = (regionStart + ring.used + stride - 1) / stride * stride;
+    size_t end   = start + stride * count;
+    if( end > regionStart + ring.regionSize ) { return result; }
+    ring.used     = end - regionStart;
+    result.data   = ring.memory + start;
+    result.offset = start;
+    result.size   = end - start;
+    return result;
+}
+
+void StreamRingTrim( StreamRing& ring, const StreamSpan& span, size_t stride, size_t usedCount ) {
+    size_t regionStart = ring.region * ring.regionSize;
+    bool latest = span.data && span.offset >= regionStart &&
+        span.offset + span.size == regionStart + ring.used;
+    if( latest && stride * usedCount <= span.size ) {
+        ring.used = span.offset + stride * usedCount - regionStart;
+    }
+}
+
+u32 StreamRingNextRegion( StreamRing& ring ) {
+    ring.region = (ring.region + 1) % STREAM_RING_REGIONS;
+    ring.used   = 0;
+    return ring.region;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "defines.hpp"
+#include <cstddef>
+
+// Bookkeeping for a buffer the cpu streams into every frame while the gpu
+// reads what earlier frames wrote. The buffer is split into regions, one per
+// frame in flight. A frame only writes its own region, so before moving on to
+// a region the backend has to wait until the gpu is done with the frame that
+// wrote it last (a fence in GL). Knows nothing about the graphics api, memory
+// is whatever the backend maps.
+
+// frames the cpu can get ahead of the gpu, plus the one being written
+const u32 STREAM_RING_REGIONS = 3;
+
+struct StreamRing {
+    u8* memory;
+    size_t regionSize;
+    // region being written and bytes of it used
+    u32 region;
+    size_t used;
+};
+
+// memory is STREAM_RING_REGIONS * regionSize bytes
+StreamRing CreateStreamRing( void* memory, size_t regionSize );
+
+struct StreamSpan {
+    // nullptr when the region is out of room
+    void* data;
+    // from the start of the buffer, a multiple of stride
+    size_t offset;
+    size_t size;
+};
+
+// Room for count elements of stride bytes in the current region. offset / stride
+// is the index of the first element when the whole buffer is bound with that stride.
+StreamSpan StreamRingPush( StreamRing& ring, size_t stride, size_t count );
+// hands back what wasn't used of a span, if nothing was pushed after it
+void StreamRingTrim( StreamRing& ring, const StreamSpan& span, size_t stride, size_t usedCount );
+// moves on to the next region and returns it, wait for it before pushing
+u32 StreamRingNextRegion( StreamRing& ring );
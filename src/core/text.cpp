@@ -0,0 +1,75 @@
+#include "text.hpp"
+
+TextMetrics CreateTextMetrics( const Font& font ) {
+    TextMetrics result = {};
+    for( u32 c = 0; c < TEXT_GLYPH_COUNT; c++ ) {
+        const Glyph& glyph = font.glyphs.at((u8)c);
+        GlyphMetrics& metrics = result.glyphs[c];
+        metrics.w        = glyph.width;
+        metrics.h        = glyph.height;
+        metrics.bearingX = 0;
+        metrics.bearingY = 0;
+        metrics.advance  = glyph.advanceWidth + 400;
+    }
+    return result;
+}
+
+TextQuad PlaceGlyph( const GlyphMetrics& glyph, u8 character, f32 x, f32 y, f32 scale ) {
+    TextQuad result = {};
+    result.x = x + glyph.bearingX * scale;
+    result.y = y - (glyph.h - glyph.bearingY) * scale;
+    result.w = glyph.w * scale;
+    result.h = glyph.h * scale;
+    result.character = character;
+    return result;
+}
+
+u32 LayoutText(
+    const TextMetrics& metrics, std::string_view text,
+    f32 x, f32 y, f32 scale, UITextStyle style,
+    TextQuad* quads, u32 maxQuads
+) {
+    u32 count = (u32)text.size() < maxQuads ? (u32)text.size() : maxQuads;
+    // characters outside the font take no space
+    const GlyphMetrics EMPTY = {};
+    switch(style) {
+        case UITextStyle::NORMAL: {
+            for( u32 i = 0; i < count; i++ ) {
+                u8 c = (u8)text[i];
+                const GlyphMetrics& glyph = c < TEXT_GLYPH_COUNT ? metrics.glyphs[c] : EMPTY;
+                quads[i] = PlaceGlyph( glyph, c, x, y, scale );
+                x += (glyph.advance >> 6) * scale;
+            }
+        } break;
+        case UITextStyle::REVERSE: {
+            for( u32 i = 0; i < count; i++ ) {
+                u8 c = (u8)text[text.size() - 1 - i];
+                const GlyphMetrics& glyph = c < TEXT_GLYPH_COUNT ? metrics.glyphs[c] : EMPTY;
+                quads[i] = PlaceGlyph( glyph, c, x - (glyph.w + glyph.bearingX) * scale, y, scale );
+                x -= (glyph.advance >> 6) * scale;
+            }
+        } break;
+    }
+    return count;
+}
+
+u32 FormatU32( u32 value, char* out ) {
+    // digits come out last first, write them to the end of a scratch buffer
+    char digits[U32_MAX_DIGITS];
+    u32 count = 0;
+    do {
+        digits[U32_MAX_DIGITS - 1 - count] = (char)('0' + value % 10);
+        value /= 10;
+        count++;
+    } while( value > 0 );
+    for( u32 i = 0; i < count; i++ ) {
+        out[i] = digits[U32_MAX_DIGITS - count + i];
+    }
+    return count;
+}
+
+std::string_view FormatU32( Arena& arena, u32 value ) {
+    char* out = ArenaPushArray<char>( arena, U32_MAX_DIGITS );
+    if( !out ) { return std::string_view(); }
+    return std::string_view( out, FormatU32(value, out) );
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "defines.hpp"
+#include "font.hpp"
+#include "ui.hpp"
+#include "arena.hpp"
+#include <string_view>
+
+// Text layout shared by every renderer, so the work of placing glyphs can
+// be measured and changed without a graphics context.
+
+// only ascii is loaded from the font
+const u32 TEXT_GLYPH_COUNT = 128;
+// digits in the longest u32
+const u32 U32_MAX_DIGITS   = 10;
+
+// sizes in pixels of the font's bitmaps
+struct GlyphMetrics {
+    i32 w; i32 h;
+    i32 bearingX;
+    i32 bearingY;
+    // in 1/64ths of a pixel
+    u32 advance;
+};
+
+struct TextMetrics {
+    GlyphMetrics glyphs[TEXT_GLYPH_COUNT];
+};
+
+// where one character is drawn, x and y are its bottom left corner
+struct TextQuad {
+    f32 x; f32 y;
+    f32 w; f32 h;
+    u8 character;
+};
+
+TextMetrics CreateTextMetrics( const Font& font );
+
+// Places each character of text starting at x, or ending at x when style is
+// REVERSE. Writes at most maxQuads quads, in the order they're laid out,
+// and returns how many it wrote.
+u32 LayoutText(
+    const TextMetrics& metrics, std::string_view text,
+    f32 x, f32 y, f32 scale, UITextStyle style,
+    TextQuad* quads, u32 maxQuads
+);
+
+// writes value in decimal to out, which has room for U32_MAX_DIGITS,
+// and returns how many digits it wrote
+u32 FormatU32( u32 value, char* out );
+// value in decimal, kept in arena
+std::string_view FormatU32( Arena& arena, u32 value );
@@ -0,0 +1,49 @@
+#include "timestep.hpp"
+
+FixedTimestep CreateFixedTimestep( f32 tickRate ) {
+    FixedTimestep result = {};
+    result.tickLength  = tickRate > 0.0f ? 1.0f / tickRate : 0.0f;
+    result.accumulator = 0.0f;
+    result.lastFrame   = 0.0f;
+    return result;
+}
+
+u32 AccumulateFrame( FixedTimestep& timestep, DeltaTime frameTime ) {
+    timestep.lastFrame = frameTime;
+    if( timestep.tickLength <= 0.0f ) { return 1; }
+
+    timestep.accumulator += frameTime;
+    u32 ticks = (u32)(timestep.accumulator / timestep.tickLength);
+    if( ticks > MAX_TICKS_PER_FRAME ) {
+        ticks = MAX_TICKS_PER_FRAME;
+        timestep.accumulator = timestep.tickLength * MAX_TICKS_PER_FRAME;
+    }
+    timestep.accumulator -= timestep.tickLength * ticks;
+    // guard against drift from the float math above
+    if( timestep.accumulator < 0.0f ) { timestep.accumulator = 0.0f; }
+    return ticks;
+}
+
+DeltaTime TickLength( const FixedTimestep& timestep ) {
+    return timestep.tickLength > 0.0f ? timestep.tickLength : timestep.lastFrame;
+}
+
+f32 InterpolationAlpha( const FixedTimestep& timestep ) {
+    if( timestep.tickLength <= 0.0f ) { return 1.0f; }
+    f32 alpha = timestep.accumulator / timestep.tickLength;
+    return alpha > 1.0f ? 1.0f : alpha;
+}
+
+f32 Lerp( f32 a, f32 b, f32 t ) { return a + (b - a) * t; }
+
+GameState InterpolateGameState( const GameState& previous, const GameState& current, f32 alpha ) {
+    GameState result = current;
+    result.player.y = Lerp( previous.player.y, current.player.y, alpha );
+    result.cpu.y    = Lerp( previous.cpu.y,    current.cpu.y,    alpha );
+    // the ball teleports to the center when a round starts, don't smear it across the field
+    if( previous.scored == current.scored ) {
+        result.ball.x = Lerp( previous.ball.x, current.ball.x, alpha );
+        result.ball.y = Lerp( previous.ball.y, current.ball.y, alpha );
+    }
+    return result;
+}
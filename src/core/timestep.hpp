@@ -0,0 +1,29 @@
+#pragma once
+#include "defines.hpp"
+#include "app.hpp"
+
+const f32 DEFAULT_TICK_RATE = 120.0f;
+// stops a long stall (dragging the window, breakpoints) from
+// turning into hundreds of catch up ticks on the next frame
+const u32 MAX_TICKS_PER_FRAME = 8;
+
+// Accumulates frame time and hands it out in ticks of a fixed length,
+// so the simulation gives the same results at any frame rate.
+// A tick rate of 0 disables it, every frame becomes one tick of variable length.
+struct FixedTimestep {
+    f32 tickLength;
+    f32 accumulator;
+    f32 lastFrame;
+};
+
+FixedTimestep CreateFixedTimestep( f32 tickRate );
+// adds a frame's time, returns how many ticks to simulate
+u32 AccumulateFrame( FixedTimestep& timestep, DeltaTime frameTime );
+// length of the next tick to simulate
+DeltaTime TickLength( const FixedTimestep& timestep );
+// how far between the last two ticks the frame is, 0 to 1
+f32 InterpolationAlpha( const FixedTimestep& timestep );
+
+// blends what is visible between the last two ticks,
+// everything else comes from current
+GameState InterpolateGameState( const GameState& previous, const GameState& current, f32 alpha );
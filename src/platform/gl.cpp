@@ -2,74 +2,58 @@
 
 #include "renderer.hpp"
 #include "platform.hpp"
+#include "./core/text.hpp"
+#include "./core/atlas.hpp"
+#include "./core/streamring.hpp"
+#include "./core/profile.hpp"
 #include "glad/glad.h"
+#include <cstring>
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include <map>
 
 GLuint shader;
 GLuint vao, vbo, ebo;
-GLint transformLoc;
-glm::mat4 ballScale, paddleScale;
-
-void RenderScore(u32 playerScore, u32 cpuScore);
-
-void RenderGame(const GameState& gameState) {
-    if( gameState.scored ) {
-        RenderScore(gameState.playerScore, gameState.cpuScore);
-    }
-    
-    glUseProgram(shader);
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-
-    if(!gameState.scored) {
-        glm::mat4 ballTransform =
-            glm::translate( glm::mat4(1.0f), glm::vec3( gameState.ball.x, gameState.ball.y, 0.0f ) ) *
-            ballScale;
-        glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(ballTransform));
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+// rectangles written per draw, more are drawn in several calls
+const u32 MAX_RECT_INSTANCES = 16384;
+
+// Every vertex and instance written per frame goes straight into one buffer
+// that stays mapped for the life of the renderer, so there is no upload call
+// for the driver to sync on. Each frame writes its own region of it and fences
+// the region at the end of the frame, the fence is waited on before the ring
+// comes back around to the region.
+const size_t STREAM_REGION_SIZE = 2 * 1024 * 1024;
+GLuint streamVbo;
+StreamRing streamRing;
+GLsync regionFences[STREAM_RING_REGIONS];
+
+// blocks until the gpu is done reading the region, almost never in practice
+void WaitForStreamRegion(u32 region) {
+    GLsync fence = regionFences[region];
+    if( !fence ) { return; }
+    PROFILE_ZONE("WaitForStreamRegion");
+    for(;;) {
+        GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        if( result != GL_TIMEOUT_EXPIRED ) { break; }
     }
-
-    glm::mat4 paddlePlayerTransform =
-        glm::translate( glm::mat4(1.0f), glm::vec3( -PADDLE_X_POS, gameState.player.y, 0.0f ) ) *
-        paddleScale;
-    glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(paddlePlayerTransform));
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
-
-    glm::mat4 paddleCPUTransform =
-        glm::translate( glm::mat4(1.0f), glm::vec3( PADDLE_X_POS, gameState.cpu.y, 0.0f ) ) *
-        paddleScale;
-    glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(paddleCPUTransform));
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+    glDeleteSync(fence);
+    regionFences[region] = nullptr;
 }
 
-void RenderScore(u32 playerScore, u32 cpuScore) {
-    f32 textX = 200.0f;
-    f32 textY = SCREEN_H - 125.0f;
-    RenderText(std::to_string(playerScore), textX, textY, TEXT_SCALE);
-    RenderText(std::to_string(cpuScore), SCREEN_W - textX, textY, TEXT_SCALE, UITextStyle::REVERSE, glm::vec3(1.0f));
+// fences everything drawn from the current region and moves on to the next
+void NextStreamRegion() {
+    regionFences[streamRing.region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    WaitForStreamRegion( StreamRingNextRegion(streamRing) );
 }
 
-void RenderMenu(const MenuOption& currentMenuOption) {
-    switch(currentMenuOption) {
-        case MenuOption::START_GAME: {
-            GetStartGameText().color = SELECT_COLOR;
-            GetQuitGameText().color  = DESELECT_COLOR;
-        } break;
-        case MenuOption::QUIT_GAME: {
-            GetStartGameText().color = DESELECT_COLOR;
-            GetQuitGameText().color  = SELECT_COLOR;
-        } break;
+// like StreamRingPush, but starts the next region when this one is full
+StreamSpan PushStream(size_t stride, size_t count) {
+    StreamSpan span = StreamRingPush(streamRing, stride, count);
+    if( !span.data ) {
+        NextStreamRegion();
+        span = StreamRingPush(streamRing, stride, count);
     }
-    RenderText( GetTitleText() );
-    RenderText( GetStartGameText() );
-    RenderText( GetQuitGameText() );
-    RenderText( GetControlsText0() );
-    RenderText( GetControlsText1() );
-    RenderText( GetControlsText2() );
+    return span;
 }
 
 #ifdef DEBUG
@@ -86,15 +70,20 @@ void GLMessageCallback(
 }
 #endif
 
-GLuint fontVao, fontVbo;
+GLuint fontVao;
 GLuint fontShader;
-GLint fontColorLoc;
+
+// glyphs written per draw, more are drawn in several calls
+const u32 MAX_TEXT_GLYPHS = 4096;
 
 bool InitializeGL( LoadFunctionGL loadFunc ) {
     return gladLoadGLLoader((GLADloadproc)loadFunc) != 0;
 }
 
 bool InitializeRenderer() {
+    // glBufferStorage
+    if( !GLAD_GL_VERSION_4_4 ) { return false; }
+
 #ifdef DEBUG
     glEnable(GL_DEBUG_OUTPUT);
     glDebugMessageCallback(
@@ -103,9 +92,6 @@ bool InitializeRenderer() {
     );
 #endif
 
-    paddleScale = glm::scale( glm::mat4(1.0f), glm::vec3(PADDLE_W, PADDLE_H, 1.0f) );
-    ballScale   = glm::scale( glm::mat4(1.0f), glm::vec3(BALL_SIZE, BALL_SIZE, 1.0f) );
-
     glGenVertexArrays(1, &vao);
     glBindVertexArray(vao);
 
@@ -141,20 +127,39 @@ bool InitializeRenderer() {
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
     glBufferData(
         GL_ELEMENT_ARRAY_BUFFER,
-        sizeof(u32) * 3 * 3,
+        sizeof(indices),
         &indices,
         GL_STATIC_DRAW
     );
 
+    GLbitfield streamFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    GLsizeiptr streamSize  = STREAM_REGION_SIZE * STREAM_RING_REGIONS;
+    glGenBuffers(1, &streamVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, streamVbo);
+    glBufferStorage(GL_ARRAY_BUFFER, streamSize, nullptr, streamFlags);
+    void* streamMemory = glMapBufferRange(GL_ARRAY_BUFFER, 0, streamSize, streamFlags);
+    if( !streamMemory ) { return false; }
+    streamRing = CreateStreamRing(streamMemory, STREAM_REGION_SIZE);
+
+    glVertexAttribPointer(
+        1, 4,
+        GL_FLOAT, GL_FALSE,
+        sizeof(RectInstance),
+        0
+    );
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(1);
+
     const char* vert_src = R"(
 #version 460 core
 layout(location = 0) in vec3 v_pos;
+// center in xy, size in zw
+layout(location = 1) in vec4 i_rect;
 
 uniform mat4 u_projection;
-uniform mat4 u_transform;
 
 void main() {
-    gl_Position = u_projection * u_transform * vec4(v_pos, 1.0);
+    gl_Position = u_projection * vec4(v_pos.xy * i_rect.zw + i_rect.xy, 0.0, 1.0);
 }
 )";
 
@@ -209,32 +214,33 @@ void main() {
         glm::value_ptr(projection)
     );
 
-    transformLoc = glGetUniformLocation(shader, "u_transform");
-
     const char* font_vert_src = R"(
 #version 460 core
 layout(location = 0) in vec4 v_vertex;
+layout(location = 1) in vec3 v_color;
 out vec2 v2f_uv;
+out vec3 v2f_color;
 
 uniform mat4 u_projection;
 
 void main() {
     gl_Position = u_projection * vec4(v_vertex.xy, 0.0, 1.0);
     v2f_uv = v_vertex.zw;
+    v2f_color = v_color;
 }
 )";
 
     const char* font_frag_src = R"(
 #version 460 core
 in vec2 v2f_uv;
+in vec3 v2f_color;
 out vec4 FRAG_COLOR;
 
 uniform sampler2D u_glyph;
-uniform vec3 u_textColor;
 
 void main() {
     float result = texture(u_glyph, v2f_uv).r;
-    FRAG_COLOR = vec4( u_textColor.rgb, result );
+    FRAG_COLOR = vec4( v2f_color, result );
 }
 )";
 
@@ -275,136 +281,136 @@ void main() {
     GLint fontSamplerLoc = glGetUniformLocation(fontShader, "u_glyph");
     glUniform1i(fontSamplerLoc, 0);
 
-    fontColorLoc = glGetUniformLocation(fontShader, "u_textColor");
-
     glGenVertexArrays(1, &fontVao);
     glBindVertexArray(fontVao);
 
-    glGenBuffers(1, &fontVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, fontVbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(f32) * 6 * 4, nullptr, GL_DYNAMIC_DRAW );
-
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(f32) * 4, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, streamVbo);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, x));
     glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, r));
+    glEnableVertexAttribArray(1);
 
     return true;
 }
 
-// TODO: Rewrite text renderer
-struct CharacterGL {
-    u32 texture;
-    i32 w; i32 h;
-    i32 bearing_x;
-    i32 bearing_y;
-    u32 advance;
-};
-void RenderCharacter(const CharacterGL& character, f32 x, f32 y, f32 scale);
-std::map<char, CharacterGL> characterMap;
-bool fontLoaded = false;
+GLuint atlasTexture;
+FontAtlas fontAtlas;
 
 void RendererLoadFont(const Font& font) {
+    fontAtlas = CreateFontAtlas(font);
+    if(!fontAtlas.pixels) { return; }
+
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    for( u8 c = 0; c < 128; c++ ) {
-        Glyph glyph = font.glyphs.at(c);
-        CharacterGL character = {};
-        glGenTextures(1, &character.texture);
-        glBindTexture(GL_TEXTURE_2D, character.texture);
-        glTexImage2D(
-            GL_TEXTURE_2D, 0,
-            GL_RED,
-            glyph.width,
-            glyph.height,
-            0, GL_RED, GL_UNSIGNED_BYTE,
-            glyph.bitmap
-        );
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        character.w         = glyph.width;
-        character.h         = glyph.height;
-        character.bearing_x = 0;
-        character.bearing_y = 0;
-        character.advance   = glyph.advanceWidth + 400;
-
-        characterMap.insert(std::pair<char, CharacterGL>( (char)c, character ));
-    }
+    glGenTextures(1, &atlasTexture);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glTexImage2D(
+        GL_TEXTURE_2D, 0,
+        GL_R8,
+        fontAtlas.width,
+        fontAtlas.height,
+        0, GL_RED, GL_UNSIGNED_BYTE,
+        fontAtlas.pixels
+    );
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-    fontLoaded = true;
+
+    FreeFontAtlasPixels(fontAtlas);
+    SetRecordTextMetrics( CreateTextMetrics(font) );
 }
-glm::vec3 lastFontColor = glm::vec3(0.0f);
-void RenderText(std::string text, f32 x, f32 y, f32 scale, UITextStyle textStyle, const glm::vec3& color) {
-    if(!fontLoaded) { return; }
-    glUseProgram(fontShader);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    if( lastFontColor != color ) {
-        glUniform3fv(fontColorLoc, 1, glm::value_ptr(color));
-        lastFontColor = color;
+// what the last submit left bound, so a run only sets what differs
+const u32 UNBOUND = 0xFFFFFFFF;
+u32 boundPipeline = UNBOUND;
+u32 boundTexture  = UNBOUND;
+u32 boundBlend    = UNBOUND;
+
+void BindRenderState(u64 key) {
+    RenderPipeline pipeline = RenderKeyPipeline(key);
+    if( (u32)pipeline != boundPipeline ) {
+        switch(pipeline) {
+            case RenderPipeline::RECTS: {
+                glUseProgram(shader);
+                glBindVertexArray(vao);
+            } break;
+            case RenderPipeline::TEXT: {
+                glUseProgram(fontShader);
+                glBindVertexArray(fontVao);
+            } break;
+        }
+        boundPipeline = (u32)pipeline;
     }
 
-    glActiveTexture(GL_TEXTURE0);
+    // untextured draws leave whatever is bound alone
+    RenderTexture texture = RenderKeyTexture(key);
+    if( texture != RenderTexture::NONE && (u32)texture != boundTexture ) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, atlasTexture);
+        boundTexture = (u32)texture;
+    }
 
-    glBindVertexArray(fontVao);
+    RenderBlend blend = RenderKeyBlend(key);
+    if( (u32)blend != boundBlend ) {
+        switch(blend) {
+            case RenderBlend::NONE: {
+                glDisable(GL_BLEND);
+            } break;
+            case RenderBlend::ALPHA: {
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            } break;
+        }
+        boundBlend = (u32)blend;
+    }
+}
 
-    switch(textStyle) {
-        case UITextStyle::NORMAL: {
-            std::string::const_iterator c;
-            for( c = text.begin(); c != text.end(); ++c ) {
-                CharacterGL character = characterMap[*c];
-                RenderCharacter(character, x, y, scale);
-                x += (character.advance >> 6) * scale;
+// sorts what's been recorded and draws every run of commands with the same
+// state straight out of the stream buffer
+void SubmitRenderCommands() {
+    PROFILE_ZONE("SubmitRenderCommands");
+    RenderCommandBuffer& renderCommands = RecordedRenderCommands();
+    SortRenderCommands(renderCommands);
+
+    for( u32 first = 0; first < renderCommands.count; ) {
+        u32 end = RenderRunEnd(renderCommands, first);
+        u64 key = renderCommands.commands[first].key;
+        BindRenderState(key);
+
+        RenderCursor cursor = { first, 0 };
+        while( cursor.command < end ) {
+            switch(RenderKeyPipeline(key)) {
+                case RenderPipeline::RECTS: {
+                    StreamSpan span = PushStream(sizeof(RectInstance), MAX_RECT_INSTANCES);
+                    if( !span.data ) { cursor.command = end; break; }
+                    u32 instances = GatherRects(renderCommands, cursor, end, (RectInstance*)span.data, MAX_RECT_INSTANCES);
+                    StreamRingTrim(streamRing, span, sizeof(RectInstance), instances);
+                    // the instance attribute starts at the front of the buffer, skip to the span
+                    glDrawElementsInstancedBaseInstance(
+                        GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr,
+                        instances, (GLuint)(span.offset / sizeof(RectInstance))
+                    );
+                } break;
+                case RenderPipeline::TEXT: {
+                    StreamSpan span = PushStream(sizeof(TextVertex), MAX_TEXT_GLYPHS * TEXT_VERTICES_PER_GLYPH);
+                    if( !span.data ) { cursor.command = end; break; }
+                    u32 vertices = GatherText(renderCommands, cursor, end, fontAtlas, (TextVertex*)span.data, MAX_TEXT_GLYPHS);
+                    StreamRingTrim(streamRing, span, sizeof(TextVertex), vertices);
+                    if( vertices > 0 ) {
+                        glDrawArrays(GL_TRIANGLES, (GLint)(span.offset / sizeof(TextVertex)), vertices);
+                    }
+                } break;
             }
-        } break;
-        case UITextStyle::REVERSE: {
-            std::string::const_reverse_iterator c;
-            for( c = text.rbegin(); c != text.rend(); ++c ) {
-                CharacterGL character = characterMap[*c];
-                RenderCharacter(character, x - (character.w + character.bearing_x) * scale, y, scale);
-                x -= (character.advance >> 6) * scale;
-            }
-        } break;
+        }
+        first = end;
     }
+    renderCommands.count = 0;
 }
-void RenderCharacter(const CharacterGL& character, f32 x, f32 y, f32 scale) {
-    f32 xpos = x + character.bearing_x * scale;
-    f32 ypos = y - (character.h - character.bearing_y) * scale;
-
-    f32 w = character.w * scale;
-    f32 h = character.h * scale;
-
-    f32 vertices[6][4] = {
-        { xpos,     ypos + h,   0.0f, 0.0f },
-        { xpos,     ypos,       0.0f, 1.0f },
-        { xpos + w, ypos,       1.0f, 1.0f },
-
-        { xpos,     ypos + h,   0.0f, 0.0f },
-        { xpos + w, ypos,       1.0f, 1.0f },
-        { xpos + w, ypos + h,   1.0f, 0.0f }
-    };
 
-    glBindTexture(GL_TEXTURE_2D, character.texture);
-    glBindBuffer(GL_ARRAY_BUFFER, fontVbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-}
-void RenderText(std::string text, f32 x, f32 y, f32 scale, UITextStyle textStyle) {
-    RenderText(text, x, y, scale, textStyle, glm::vec3(1.0f));
-}
-void RenderText(std::string text, f32 x, f32 y, f32 scale) {
-    RenderText(text, x, y, scale, UITextStyle::NORMAL);
-}
-void RenderText(const UITextElement& textElement) {
-    RenderText(
-        textElement.text,
-        textElement.xPos,
-        textElement.yPos,
-        textElement.scale,
-        textElement.style,
-        textElement.color
-    );
+void RendererEndFrame() {
+    SubmitRenderCommands();
+    NextStreamRegion();
 }
 
 void ClearScreen() { glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); }
@@ -0,0 +1,102 @@
+#ifdef NULL_RENDERER
+
+#include "renderer.hpp"
+#include "./core/text.hpp"
+#include "./core/atlas.hpp"
+#include "./core/streamring.hpp"
+
+NullRendererStats stats;
+FontAtlas fontAtlas;
+
+// the gl backend's stream buffer in plain memory, there's no gpu to fence
+const size_t STREAM_REGION_SIZE = 2 * 1024 * 1024;
+u8 streamMemory[STREAM_REGION_SIZE * STREAM_RING_REGIONS];
+StreamRing streamRing = CreateStreamRing(streamMemory, STREAM_REGION_SIZE);
+
+StreamSpan PushStream(size_t stride, size_t count) {
+    StreamSpan span = StreamRingPush(streamRing, stride, count);
+    if( !span.data ) {
+        StreamRingNextRegion(streamRing);
+        span = StreamRingPush(streamRing, stride, count);
+    }
+    return span;
+}
+
+// same draw sizes as the gl backend
+const u32 MAX_TEXT_GLYPHS = 4096;
+
+NullRendererStats& GetNullRendererStats() { return stats; }
+
+bool InitializeRenderer() { return true; }
+
+void ClearScreen() {}
+
+const u32 MAX_RECT_INSTANCES = 16384;
+
+void RendererLoadFont(const Font& font) {
+    fontAtlas = CreateFontAtlas(font);
+    if(!fontAtlas.pixels) { return; }
+    FreeFontAtlasPixels(fontAtlas);
+    SetRecordTextMetrics( CreateTextMetrics(font) );
+}
+
+// what the last submit left bound
+const u32 UNBOUND = 0xFFFFFFFF;
+u32 boundPipeline = UNBOUND;
+u32 boundTexture  = UNBOUND;
+u32 boundBlend    = UNBOUND;
+
+void BindRenderState(u64 key) {
+    u32 pipeline = (u32)RenderKeyPipeline(key);
+    u32 texture  = (u32)RenderKeyTexture(key);
+    u32 blend    = (u32)RenderKeyBlend(key);
+    if( pipeline != boundPipeline ) { stats.stateChanges++; boundPipeline = pipeline; }
+    if( texture != (u32)RenderTexture::NONE && texture != boundTexture ) { stats.stateChanges++; boundTexture = texture; }
+    if( blend != boundBlend ) { stats.stateChanges++; boundBlend = blend; }
+}
+
+// submitted the same way as the gl backend
+void SubmitRenderCommands() {
+    RenderCommandBuffer& renderCommands = RecordedRenderCommands();
+    SortRenderCommands(renderCommands);
+    for( u32 first = 0; first < renderCommands.count; ) {
+        u32 end = RenderRunEnd(renderCommands, first);
+        u64 key = renderCommands.commands[first].key;
+        BindRenderState(key);
+
+        RenderCursor cursor = { first, 0 };
+        while( cursor.command < end ) {
+            switch(RenderKeyPipeline(key)) {
+                case RenderPipeline::RECTS: {
+                    StreamSpan span = PushStream(sizeof(RectInstance), MAX_RECT_INSTANCES);
+                    if( !span.data ) { cursor.command = end; break; }
+                    u32 instances = GatherRects(renderCommands, cursor, end, (RectInstance*)span.data, MAX_RECT_INSTANCES);
+                    StreamRingTrim(streamRing, span, sizeof(RectInstance), instances);
+                    stats.checksum += ((RectInstance*)span.data)[instances - 1].x;
+                    stats.draws++;
+                } break;
+                case RenderPipeline::TEXT: {
+                    StreamSpan span = PushStream(sizeof(TextVertex), MAX_TEXT_GLYPHS * TEXT_VERTICES_PER_GLYPH);
+                    if( !span.data ) { cursor.command = end; break; }
+                    u32 vertices = GatherText(renderCommands, cursor, end, fontAtlas, (TextVertex*)span.data, MAX_TEXT_GLYPHS);
+                    StreamRingTrim(streamRing, span, sizeof(TextVertex), vertices);
+                    if( vertices > 0 ) {
+                        const TextVertex& last = ((TextVertex*)span.data)[vertices - 1];
+                        stats.checksum += last.x + last.v + last.r;
+                        stats.glyphs += vertices / TEXT_VERTICES_PER_GLYPH;
+                        stats.draws++;
+                    }
+                } break;
+            }
+        }
+        first = end;
+    }
+    renderCommands.count = 0;
+}
+
+void RendererEndFrame() {
+    SubmitRenderCommands();
+    StreamRingNextRegion(streamRing);
+}
+
+#endif
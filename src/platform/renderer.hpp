@@ -1,23 +1,33 @@
 #pragma once
 #include "./core/font.hpp"
-#include "./core/app.hpp"
-#include <glm/vec3.hpp>
-#include <string>
-#include "./core/ui.hpp"
+#include "./core/renderrecord.hpp"
 
 #ifdef OPENGL
 typedef void* (*LoadFunctionGL)(const char*);
 bool InitializeGL(LoadFunctionGL);
 #endif
 
+#ifdef NULL_RENDERER
+// The null renderer does all the cpu side work of a frame and throws the
+// results away instead of drawing, for benchmarks and machines without a gpu.
+struct NullRendererStats {
+    // draw calls a real backend would have made
+    u64 draws;
+    // shader, texture and blend changes it would have made
+    u64 stateChanges;
+    u64 glyphs;
+    // sum of every vertex, so the work can't be optimized out
+    f32 checksum;
+};
+NullRendererStats& GetNullRendererStats();
+#endif
+
+// Each backend sets up its api, loads the font and draws what the Render calls
+// in renderrecord.hpp recorded. Nothing is drawn until RendererEndFrame.
 bool InitializeRenderer();
-void RenderMenu(const MenuOption& currentMenuOption);
 
 void ClearScreen();
-void RenderGame(const GameState& gameState);
+// makes the font's atlas and hands its metrics to the recorder
 void RendererLoadFont(const Font& font);
-void RenderText(std::string text, f32 x, f32 y, f32 scale, UITextStyle textStyle, const glm::vec3& color);
-
-void RenderText(std::string text, f32 x, f32 y, f32 scale, UITextStyle textStyle);
-void RenderText(std::string text, f32 x, f32 y, f32 scale);
-void RenderText(const UITextElement& textElement);
+// draws everything recorded during the frame, in as few state changes and draws as fit
+void RendererEndFrame();
@@ -9,11 +9,24 @@
 #include "./core/app.hpp"
 #include "./core/platform.hpp"
 #include "./core/font.hpp"
+#include "./core/timestep.hpp"
+#include "./core/profile.hpp"
+#include "./core/framestats.hpp"
+#include "./core/arena.hpp"
+#include "./core/allocations.hpp"
 #include "renderer.hpp"
 
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
 
 const char* FONT_PATH = "./resources/HyperspaceBold.otf";
+// written on exit in builds with PROFILE defined
+const char* TRACE_PATH = "./trace.json";
+// frame time statistics are added to it on exit and when F3 is pressed
+const char* FRAME_STATS_PATH = "./frame_stats.txt";
+// frames after these must not allocate, the first ones can still be setting up
+const u32 ALLOCATION_FREE_AFTER = 60;
 
 #ifdef OPENGL
 HGLRC CreateGLContext();
@@ -25,13 +38,17 @@ FileReadResult ReadEntireFile(const char* filename);
 void ProcessMessages(PlayerInput& input);
 void FreeFileMemory(void* fileMemory);
 f64 ElapsedTime();
+f32 ParseTickRate(const char* cmdLine);
+f64 EndFramePhase(FrameStats& stats, FramePhase phase, f64 phaseStart);
+void DumpFrameStats(const FrameStats& stats);
 
 HWND g_hWnd;
 HDC  g_hdc;
 f64 g_perfFrequency;
 u64 g_perfCounterStart;
+bool g_dumpFrameStats = false;
 
-int APIENTRY WinMain(HINSTANCE hInst, HINSTANCE, PSTR, int) {
+int APIENTRY WinMain(HINSTANCE hInst, HINSTANCE, PSTR cmdLine, int) {
     if(!InitWindow(hInst)) {
         ErrorBox("Failed to create win64 Window!");
         return -1;
@@ -51,6 +68,8 @@ int APIENTRY WinMain(HINSTANCE hInst, HINSTANCE, PSTR, int) {
 
     Pong pong = Pong();
     PlayerInput input = {};
+    FixedTimestep timestep  = CreateFixedTimestep( ParseTickRate(cmdLine) );
+    GameState previousState = pong.GetGameState();
 
     if( !InitializeRenderer() ) {
         ErrorBox("Failed to initialize renderer!");
@@ -69,36 +88,109 @@ int APIENTRY WinMain(HINSTANCE hInst, HINSTANCE, PSTR, int) {
         return -1;
     }
 
+    PROFILE_THREAD_NAME("Main");
+    FrameStats frameStats = CreateFrameStats();
+    u32 frameIndex = 0;
+    bool reportedAllocation = false;
+    bool reportedDropped    = false;
     f32 lastElapsedTime = 0.0;
     while(g_RUNNING) {
-        ProcessMessages(input);
+        PROFILE_ZONE("Frame");
+        ResetArena(FrameArena());
+        u64 allocationsBefore = AllocationCount();
+        f64 phaseStart = ElapsedTime();
+        {
+            PROFILE_ZONE("ProcessMessages");
+            ProcessMessages(input);
+        }
+        phaseStart = EndFramePhase(frameStats, FramePhase::MESSAGES, phaseStart);
         f32 elapsedTime     = ElapsedTime();
         DeltaTime deltaTime = elapsedTime - lastElapsedTime;
+        // the first frame's delta is the time it took to start up
+        if( lastElapsedTime > 0.0f ) { RecordFrame(frameStats, deltaTime); }
         lastElapsedTime     = elapsedTime;
 
         switch(pong.CurrentScene()) {
             case Scene::MAIN_MENU: {
+                PROFILE_ZONE("UpdateMenu");
                 pong.UpdateMenu(input);
             } break;
             case Scene::IN_GAME: {
-                pong.UpdateGame(deltaTime, input);
+                PROFILE_ZONE("UpdateGame");
+                u32 ticks = AccumulateFrame(timestep, deltaTime);
+                for( u32 tick = 0; tick < ticks; tick++ ) {
+                    previousState = pong.GetGameState();
+                    pong.UpdateGame(TickLength(timestep), input);
+                }
             } break;
         }
+        phaseStart = EndFramePhase(frameStats, FramePhase::UPDATE, phaseStart);
 
-        ClearScreen();
+        {
+            PROFILE_ZONE("ClearScreen");
+            ClearScreen();
+        }
+        phaseStart = EndFramePhase(frameStats, FramePhase::CLEAR, phaseStart);
         switch(pong.CurrentScene()) {
             case Scene::MAIN_MENU: {
+                PROFILE_ZONE("RenderMenu");
                 RenderMenu(pong.GetSelectedMenuOption());
             } break;
             case Scene::IN_GAME: {
-                RenderGame(pong.GetGameState());
+                PROFILE_ZONE("RenderGame");
+                RenderGame( InterpolateGameState(
+                    previousState, pong.GetGameState(),
+                    InterpolationAlpha(timestep)
+                ) );
             } break;
         }
+        RendererEndFrame();
+        phaseStart = EndFramePhase(frameStats, FramePhase::RENDER, phaseStart);
 
 #ifdef OPENGL
-    SwapBuffers(g_hdc);
+    {
+        PROFILE_ZONE("SwapBuffers");
+        SwapBuffers(g_hdc);
+    }
+#endif
+        EndFramePhase(frameStats, FramePhase::SWAP, phaseStart);
+
+        if( g_dumpFrameStats ) {
+            DumpFrameStats(frameStats);
+            g_dumpFrameStats = false;
+        }
+
+        u64 allocations = AllocationCount() - allocationsBefore;
+        if( ALLOCATIONS_COUNTED && allocations > 0 &&
+            frameIndex >= ALLOCATION_FREE_AFTER && !reportedAllocation
+        ) {
+            // once, the message box allocates too
+            reportedAllocation = true;
+            ErrorBox(
+                "Frame " + std::to_string(frameIndex) + " made " +
+                std::to_string(allocations) + " heap allocations!"
+            );
+        }
+#ifdef DEBUG
+        // the command buffer filled up and part of a frame wasn't drawn
+        u64 dropped = RecordedRenderCommands().dropped;
+        if( dropped > 0 && !reportedDropped ) {
+            reportedDropped = true;
+            ErrorBox(
+                "Frame " + std::to_string(frameIndex) + " dropped " +
+                std::to_string(dropped) + " render commands!"
+            );
+        }
 #endif
+        frameIndex++;
     }
+    DumpFrameStats(frameStats);
+
+#ifdef PROFILE
+    if( !WriteChromeTrace(TRACE_PATH) ) {
+        ErrorBox("Failed to write trace to " + std::string(TRACE_PATH));
+    }
+#endif
 
 #ifdef OPENGL
     wglMakeCurrent(nullptr, nullptr);
@@ -183,6 +275,7 @@ void ProcessMessages(PlayerInput& input) {
             else if( message.wParam == VK_UP || message.wParam == 'W' ) { input.up = true; }
             else if( message.wParam == VK_RETURN || message.wParam == VK_SPACE ) { input.enter = true; }
             else if( message.wParam == VK_ESCAPE ) { g_RUNNING = false; }
+            else if( message.wParam == VK_F3 ) { g_dumpFrameStats = true; }
         } break;
         case WM_KEYUP: {
             if( message.wParam == VK_DOWN    || message.wParam == 'S' )  { input.down = false; }
@@ -322,6 +415,28 @@ void ErrorBox(std::string errorMessage) {
 
 void FreeFileMemory(void* fileMemory) { VirtualFree( fileMemory, 0, MEM_RELEASE ); }
 
+// -tickrate <ticks per second>, 0 steps once per frame with a variable delta
+f32 ParseTickRate(const char* cmdLine) {
+    const char* flag = strstr(cmdLine, "-tickrate");
+    if(!flag) { return DEFAULT_TICK_RATE; }
+    return (f32)atof( flag + strlen("-tickrate") );
+}
+
+// records the time since phaseStart, returns now for the start of the next phase
+f64 EndFramePhase(FrameStats& stats, FramePhase phase, f64 phaseStart) {
+    f64 now = ElapsedTime();
+    RecordFramePhase(stats, phase, now - phaseStart);
+    return now;
+}
+
+void DumpFrameStats(const FrameStats& stats) {
+    FILE* out = fopen(FRAME_STATS_PATH, "a");
+    if(!out) { return; }
+    fprintf(out, "\n%.1f s after start\n", ElapsedTime());
+    WriteFrameStats(stats, out);
+    fclose(out);
+}
+
 f64 ElapsedTime() {
     LARGE_INTEGER lpPerformanceCount;
     if(QueryPerformanceCounter(&lpPerformanceCount) == FALSE) {
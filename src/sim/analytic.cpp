@@ -0,0 +1,154 @@
+#include "analytic.hpp"
+#include <algorithm>
+#include <cmath>
+
+// more quiet ticks than this are never skipped in one go
+const u32 MAX_QUIET_TICKS = 1u << 30;
+// fraction of a tick that a game time can fall short of a tick boundary by
+// and still count as on it, long matches lose that much to rounding
+const f64 TICK_ROUNDING = 1e-6;
+
+// the tick a game time falls in, a time on a tick boundary starts that tick
+u32 TickAt( f64 time, DeltaTime tickLength ) {
+    return (u32)(time / tickLength + TICK_ROUNDING);
+}
+
+// Ticks a value moving by step every tick can take while staying short of limit.
+// One short of the exact count, so the tick it gets there on is always played by
+// StepMatch even if the division rounds up. MAX_QUIET_TICKS if it never gets there.
+u32 TicksBefore( f32 value, f32 step, f32 limit ) {
+    if( step == 0.0f ) { return MAX_QUIET_TICKS; }
+    f32 ticks = (limit - value) / step;
+    if( ticks < 0.0f ) { return MAX_QUIET_TICKS; }
+    if( ticks >= (f32)MAX_QUIET_TICKS ) { return MAX_QUIET_TICKS; }
+    u32 whole = (u32)ticks;
+    return whole > 0 ? whole - 1 : 0;
+}
+
+// ticks before something moving by step reaches [low, high], 0 if it's in it
+u32 TicksOutside( f32 value, f32 step, f32 low, f32 high ) {
+    if( value >= low && value <= high ) { return 0; }
+    return TicksBefore( value, step, value < low ? low : high );
+}
+
+// how far a paddle moves each tick, 0 if MovePaddle holds it at a wall
+f32 PaddleStep( f32 paddleY, f32 delta, const GameRules& rules ) {
+    return MovePaddle( paddleY, delta, rules ) == paddleY ? 0.0f : delta;
+}
+
+// ticks before MovePaddle holds a paddle moving by step at a wall
+u32 TicksBeforeWall( f32 paddleY, f32 step, const GameRules& rules ) {
+    if( step > 0.0f ) { return TicksBefore( paddleY, step, rules.fieldH - rules.PaddleHalfH() ); }
+    if( step < 0.0f ) { return TicksBefore( paddleY, step, -rules.fieldH + rules.PaddleHalfH() ); }
+    return MAX_QUIET_TICKS;
+}
+
+// ticks WaitForRound waits before serving, one short like TicksBefore. The timer
+// is added up the way WaitForRound does it so the serve lands on the same tick
+u32 TicksBeforeServe( f32 scoreTimer, DeltaTime tickLength, f32 delay ) {
+    u32 ticks = 0;
+    while( scoreTimer + tickLength < delay ) {
+        scoreTimer += tickLength;
+        ticks++;
+    }
+    return ticks > 0 ? ticks - 1 : 0;
+}
+
+AnalyticStats AdvanceMatchAnalytic( const MatchRef& match, f64 time, f64 duration, DeltaTime tickLength, const PlayerInput* input ) {
+    const GameRules& rules = match.rules;
+    const f32 ballHalf  = rules.BallHalfSize();
+    const f32 reachW    = rules.PaddleHalfW() + ballHalf;
+    const f32 reachH    = rules.PaddleHalfH() + ballHalf;
+    const f32 botStep   = rules.paddleSpeed * tickLength;
+
+    AnalyticStats stats = {};
+    u32 endTick = TickAt( time + duration, tickLength );
+
+    while( match.tick < endTick ) {
+        u32 quiet = endTick - match.tick;
+
+        // the per tick deltas are worked out exactly the way StepMatch does them
+        bool botActive = !input && match.ballX <= -CPU_REACT_X;
+        f32 playerStep = input ? PaddleStep( match.playerY, rules.paddleSpeed * PlayerDY(*input) * tickLength, rules ) : 0.0f;
+        f32 cpuStep    = PaddleStep( match.cpuY, CpuDY(match.ballX, match.ballY, match.dirX, match.dirY, match.cpuY, rules) * tickLength, rules );
+        f32 ballStepX  = match.scored ? 0.0f : match.dirX * tickLength * rules.ballSpeed;
+        f32 ballStepY  = match.scored ? 0.0f : match.dirY * tickLength * rules.ballSpeed;
+
+        if( match.scored ) {
+            quiet = std::min( quiet, TicksBeforeServe(match.scoreTimer, tickLength, rules.delayBetweenRounds) );
+        } else {
+            // walls and goals
+            quiet = std::min( quiet, TicksBefore(match.ballY, ballStepY, ballStepY > 0.0f ? rules.fieldH - ballHalf : -rules.fieldH + ballHalf) );
+            quiet = std::min( quiet, TicksBefore(match.ballX, ballStepX, ballStepX > 0.0f ? rules.fieldW + ballHalf : -rules.fieldW - ballHalf) );
+            // a paddle can only be hit once the ball is in its column and level with it,
+            // BotInput keeps its paddle close to the ball so it counts as always level
+            quiet = std::min( quiet, std::max(
+                TicksOutside(match.ballX, ballStepX, -rules.paddleX - reachW, -rules.paddleX + reachW),
+                botActive ? 0 : TicksOutside(match.ballY - match.playerY, ballStepY - playerStep, -reachH, reachH) ) );
+            quiet = std::min( quiet, std::max(
+                TicksOutside(match.ballX, ballStepX, rules.paddleX - reachW, rules.paddleX + reachW),
+                TicksOutside(match.ballY - match.cpuY, ballStepY - cpuStep, -reachH, reachH) ) );
+            // the cpu going for the ball
+            if( match.dirX > 0.0f && match.ballX <= rules.cpuAimX ) {
+                quiet = std::min( quiet, TicksBefore(match.ballX, ballStepX, rules.cpuAimX) );
+            }
+        }
+
+        // BotInput wakes up and goes to sleep at the reaction line. Awake it changes
+        // its mind every few ticks chasing the ball, that's left to the jump below,
+        // as long as it can't get to a wall
+        if( !input ) {
+            quiet = std::min( quiet, TicksBefore(match.ballX, ballStepX, -CPU_REACT_X) );
+        }
+        if( botActive ) {
+            quiet = std::min( quiet, std::min(TicksBeforeWall(match.playerY, botStep, rules), TicksBeforeWall(match.playerY, -botStep, rules)) );
+        } else {
+            quiet = std::min( quiet, TicksBeforeWall(match.playerY, playerStep, rules) );
+        }
+
+        // CpuDY only changes its mind when the cpu gets close to where it's going
+        if( cpuStep != 0.0f ) {
+            f32 target = CpuAiming(match.ballX, match.dirX, rules) ?
+                InterceptY(match.ballX, match.ballY, match.dirX, match.dirY, rules) : 0.0f;
+            quiet = std::min( quiet, TicksBefore(match.cpuY, cpuStep, cpuStep > 0.0f ? target - CpuAimSlack(rules) : target + CpuAimSlack(rules)) );
+            quiet = std::min( quiet, TicksBeforeWall(match.cpuY, cpuStep, rules) );
+        }
+
+        // Jump over the ticks where nothing changes. Positions are added up a tick
+        // at a time like StepMatch adds them, a single multiply rounds differently
+        // and the difference is enough to move a hit or a miss by a tick sooner or later.
+        if( quiet > 0 ) {
+            f32 ballX   = match.ballX;
+            f32 ballY   = match.ballY;
+            f32 playerY = match.playerY;
+            f32 cpuY    = match.cpuY;
+            f32 timer   = match.scoreTimer;
+            if( botActive ) {
+                for( u32 tick = 0; tick < quiet; tick++ ) {
+                    f32 step = rules.paddleSpeed * PlayerDY(BotInput(ballX, ballY, playerY, rules)) * tickLength;
+                    ballX += ballStepX; ballY += ballStepY; playerY += step; cpuY += cpuStep;
+                }
+            } else {
+                for( u32 tick = 0; tick < quiet; tick++ ) {
+                    ballX += ballStepX; ballY += ballStepY; playerY += playerStep; cpuY += cpuStep;
+                }
+            }
+            if( match.scored ) {
+                for( u32 tick = 0; tick < quiet; tick++ ) { timer += tickLength; }
+            }
+            match.ballX      = ballX;
+            match.ballY      = ballY;
+            match.playerY    = playerY;
+            match.cpuY       = cpuY;
+            match.scoreTimer = timer;
+            match.tick += quiet;
+        }
+
+        // and play the one where something might
+        if( match.tick < endTick ) {
+            StepMatch( match, tickLength, input ? *input : BotInput(match.ballX, match.ballY, match.playerY, rules) );
+            stats.events++;
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "defines.hpp"
+#include "./core/physics.hpp"
+#include "./core/timestep.hpp"
+
+// Event driven simulation of a match against CpuDY, with BotInput or a held input
+// playing the left paddle. It plays the same ticks StepMatch does and ends up with
+// the same match, bit for bit, but only steps the ticks where something can change.
+// Everything else moves the same distance every tick, so the number of ticks until
+// the next event is solved for and the match jumps straight to it.
+// Events are a wall, paddle or goal getting close, a round starting, a paddle
+// getting close to a wall and either AI changing its mind (the ball crossing the
+// bot's reaction line or cpuAimX, the cpu getting close to its intercept).
+// BotInput chasing the ball changes its mind every few ticks, so while it's awake
+// the jumps run it on every tick instead of stopping for it.
+
+struct AnalyticStats {
+    // ticks stepped with StepMatch, the rest were jumped over
+    u64 events;
+};
+
+// Plays the match on from match.tick to the tick that time + duration seconds of
+// game time falls in. The caller keeps the game time, so steps of any length line
+// up with the game's ticks, and a step that ends partway through a tick leaves it
+// to the next step. tickLength is how long the game's ticks are, a bounce off the
+// middle of a paddle draws the rng for its tick the same as in StepMatch.
+// input holds the left paddle for the whole duration, nullptr lets BotInput play it.
+AnalyticStats AdvanceMatchAnalytic( const MatchRef& match, f64 time, f64 duration, DeltaTime tickLength, const PlayerInput* input = nullptr );
+
+// swept steps play the game's own ticks
+const DeltaTime SWEPT_TICK_LENGTH = 1.0f / DEFAULT_TICK_RATE;
+
+// Steps a match by ts seconds from time seconds in, for steps far longer than a
+// tick. The ball can't pass through a paddle or wall no matter how long ts is and
+// the match plays out the same as stepping StepMatch every SWEPT_TICK_LENGTH.
+inline void StepMatchSwept( const MatchRef& match, f64 time, DeltaTime ts, const PlayerInput* input ) {
+    AdvanceMatchAnalytic( match, time, ts, SWEPT_TICK_LENGTH, input );
+}
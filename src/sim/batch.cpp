@@ -0,0 +1,188 @@
+#include "batch.hpp"
+#include "jobs.hpp"
+#include "analytic.hpp"
+#include <new>
+
+const size_t BATCH_MEMORY_ALIGN = 64;
+
+BatchState CreateBatch( u32 count, u64 seed ) {
+    BatchState result = {};
+    result.count    = count;
+    result.capacity = (count + BATCH_LANE_ALIGN - 1) / BATCH_LANE_ALIGN * BATCH_LANE_ALIGN;
+
+    // every field has 4 byte elements except rngKey and scored,
+    // capacity is a multiple of 16 so all arrays stay 64 byte aligned
+    size_t longArray = sizeof(u64) * result.capacity;
+    size_t wordArray = sizeof(u32) * result.capacity;
+    size_t byteArray = sizeof(bool) * result.capacity;
+    size_t byteArrayAligned = (byteArray + BATCH_MEMORY_ALIGN - 1) / BATCH_MEMORY_ALIGN * BATCH_MEMORY_ALIGN;
+    size_t size = longArray + wordArray * 10 + byteArrayAligned;
+
+    result.memory = ::operator new( size, std::align_val_t(BATCH_MEMORY_ALIGN) );
+
+    u8* cursor = (u8*)result.memory;
+    result.rngKey      = (u64*)cursor; cursor += longArray;
+    result.ballX       = (f32*)cursor; cursor += wordArray;
+    result.ballY       = (f32*)cursor; cursor += wordArray;
+    result.dirX        = (f32*)cursor; cursor += wordArray;
+    result.dirY        = (f32*)cursor; cursor += wordArray;
+    result.playerY     = (f32*)cursor; cursor += wordArray;
+    result.cpuY        = (f32*)cursor; cursor += wordArray;
+    result.playerScore = (u32*)cursor; cursor += wordArray;
+    result.cpuScore    = (u32*)cursor; cursor += wordArray;
+    result.scoreTimer  = (f32*)cursor; cursor += wordArray;
+    result.tick        = (u32*)cursor; cursor += wordArray;
+    result.scored      = (bool*)cursor;
+    result.rules       = DEFAULT_RULES;
+
+    ResetBatch(result, seed);
+    return result;
+}
+
+void FreeBatch( BatchState& batch ) {
+    if(batch.memory) {
+        ::operator delete( batch.memory, std::align_val_t(BATCH_MEMORY_ALIGN) );
+    }
+    batch = {};
+}
+
+void ResetBatch( BatchState& batch, u64 seed ) {
+    // padding lanes are simulated too, keep them in a valid state
+    for( u32 lane = 0; lane < batch.capacity; lane++ ) {
+        ResetLane( batch, lane, MatchRngKey(seed, lane) );
+    }
+}
+
+void ResetLane( BatchState& batch, u32 lane, u64 rngKey ) {
+    static const GameState initial = Pong().GetGameState();
+    StoreGameState( batch, lane, initial );
+    batch.scoreTimer[lane] = 0.0f;
+    batch.rngKey[lane]     = rngKey;
+    batch.tick[lane]       = 0;
+}
+
+void ScatterBatch( BatchState& batch, u64 seed ) {
+    for( u32 lane = 0; lane < batch.capacity; lane++ ) {
+        u64 key = MatchRngKey( seed, lane );
+        u32 draw = 0;
+        auto next = [key, &draw]() {
+            return (f32)(Squares32(draw++, key) >> 8) / (f32)(1u << 24);
+        };
+        f32 angle = (next() - 0.5f) * 1.2f;
+        batch.ballX[lane]   = (next() - 0.5f) * batch.rules.fieldW;
+        batch.ballY[lane]   = (next() - 0.5f) * batch.rules.fieldH;
+        batch.dirX[lane]    = next() < 0.5f ? -cosf(angle) : cosf(angle);
+        batch.dirY[lane]    = sinf(angle);
+        batch.playerY[lane] = (next() - 0.5f) * batch.rules.fieldH;
+        batch.cpuY[lane]    = (next() - 0.5f) * batch.rules.fieldH;
+        batch.scored[lane]  = next() < 0.1f;
+    }
+}
+
+GameState LoadGameState( const BatchState& batch, u32 lane ) {
+    GameState result = {};
+    result.ball.x      = batch.ballX[lane];
+    result.ball.y      = batch.ballY[lane];
+    result.ball.direction.x = batch.dirX[lane];
+    result.ball.direction.y = batch.dirY[lane];
+    result.player.y    = batch.playerY[lane];
+    result.cpu.y       = batch.cpuY[lane];
+    result.playerScore = batch.playerScore[lane];
+    result.cpuScore    = batch.cpuScore[lane];
+    result.scored      = batch.scored[lane];
+    return result;
+}
+
+void StoreGameState( BatchState& batch, u32 lane, const GameState& gameState ) {
+    batch.ballX[lane]       = gameState.ball.x;
+    batch.ballY[lane]       = gameState.ball.y;
+    batch.dirX[lane]        = gameState.ball.direction.x;
+    batch.dirY[lane]        = gameState.ball.direction.y;
+    batch.playerY[lane]     = gameState.player.y;
+    batch.cpuY[lane]        = gameState.cpu.y;
+    batch.playerScore[lane] = gameState.playerScore;
+    batch.cpuScore[lane]    = gameState.cpuScore;
+    batch.scored[lane]      = gameState.scored;
+}
+
+MatchRef LaneRef( BatchState& batch, u32 lane ) {
+    return MatchRef {
+        batch.ballX[lane], batch.ballY[lane],
+        batch.dirX[lane], batch.dirY[lane],
+        batch.playerY[lane], batch.cpuY[lane],
+        batch.playerScore[lane], batch.cpuScore[lane],
+        batch.scored[lane], batch.scoreTimer[lane],
+        batch.rngKey[lane], batch.tick[lane],
+        batch.rules
+    };
+}
+
+const char* SimdLevelName( SimdLevel level ) {
+    switch(level) {
+        case SimdLevel::SIMD_SCALAR: return "scalar";
+        case SimdLevel::SIMD_SSE41:  return "sse4.1";
+        case SimdLevel::SIMD_AVX2:   return "avx2";
+        case SimdLevel::SIMD_AVX512: return "avx512";
+        default: return "unknown";
+    }
+}
+
+SimdLevel DetectSimdLevel() {
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports("avx512f") ) { return SimdLevel::SIMD_AVX512; }
+    if( __builtin_cpu_supports("avx2") )    { return SimdLevel::SIMD_AVX2; }
+    if( __builtin_cpu_supports("sse4.1") )  { return SimdLevel::SIMD_SSE41; }
+    return SimdLevel::SIMD_SCALAR;
+}
+
+void StepBatch( BatchState& batch, u32 first, u32 count, DeltaTime ts, const PlayerInput* inputs ) {
+    static const SimdLevel level = DetectSimdLevel();
+    StepBatchLevel( batch, first, count, ts, inputs, level );
+}
+
+void StepBatchLevel( BatchState& batch, u32 first, u32 count, DeltaTime ts, const PlayerInput* inputs, SimdLevel level ) {
+    switch(level) {
+        case SimdLevel::SIMD_SSE41: {
+            StepBatchSse41( batch, first, count, ts, inputs );
+        } return;
+        case SimdLevel::SIMD_AVX2: {
+            StepBatchAvx2( batch, first, count, ts, inputs );
+        } return;
+        case SimdLevel::SIMD_AVX512: {
+            StepBatchAvx512( batch, first, count, ts, inputs );
+        } return;
+        default: break;
+    }
+
+    u32 last = first + count;
+    for( u32 lane = first; lane < last; lane++ ) {
+        MatchRef match = LaneRef( batch, lane );
+        PlayerInput input = inputs ? inputs[lane] :
+            BotInput( match.ballX, match.ballY, match.playerY, batch.rules );
+        StepMatch( match, ts, input );
+    }
+}
+
+void StepBatchSwept( BatchState& batch, u32 first, u32 count, f64 time, DeltaTime ts, const PlayerInput* inputs ) {
+    u32 last = first + count;
+    for( u32 lane = first; lane < last; lane++ ) {
+        StepMatchSwept( LaneRef( batch, lane ), time, ts, inputs ? &inputs[lane] : nullptr );
+    }
+}
+
+void StepBatchVersus( BatchState& batch, u32 first, u32 count, DeltaTime ts, const PlayerInput* inputs, const PlayerInput* cpuInputs ) {
+    u32 last = first + count;
+    for( u32 lane = first; lane < last; lane++ ) {
+        StepMatchVersus( LaneRef( batch, lane ), ts, inputs[lane], cpuInputs[lane] );
+    }
+}
+
+void RunBatch( JobPool& pool, BatchState& batch, u32 ticks, DeltaTime ts, u32 grain ) {
+    grain = (grain + BATCH_LANE_ALIGN - 1) / BATCH_LANE_ALIGN * BATCH_LANE_ALIGN;
+    if( grain == 0 ) { grain = BATCH_LANE_ALIGN; }
+    ParallelFor( pool, batch.capacity, grain, [&batch, ticks, ts]( u32 first, u32 count ) {
+        for( u32 tick = 0; tick < ticks; tick++ ) {
+            StepBatch( batch, first, count, ts, nullptr );
+        }
+    } );
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "defines.hpp"
+#include "./core/app.hpp"
+#include "./core/physics.hpp"
+
+// lane counts are rounded up to this so every array can be walked
+// in whole SIMD registers and split between threads without sharing cache lines
+const u32 BATCH_LANE_ALIGN = 16;
+
+// Many independent matches stored as a structure of arrays.
+// Every field is a contiguous array of `capacity` elements.
+struct BatchState {
+    u32 count;
+    u32 capacity;
+
+    f32*  ballX;
+    f32*  ballY;
+    f32*  dirX;
+    f32*  dirY;
+    f32*  playerY;
+    f32*  cpuY;
+    u32*  playerScore;
+    u32*  cpuScore;
+    bool* scored;
+    f32*  scoreTimer;
+    // each lane draws from its own counter based rng, see rng.hpp
+    u64*  rngKey;
+    u32*  tick;
+
+    // shared by every lane, set after CreateBatch to play by other rules
+    GameRules rules;
+
+    void* memory;
+};
+
+// lane i is match id i of the given seed
+BatchState CreateBatch( u32 count, u64 seed = DEFAULT_RNG_SEED );
+void FreeBatch( BatchState& batch );
+
+// every match starts the same way a new Pong does
+void ResetBatch( BatchState& batch, u64 seed = DEFAULT_RNG_SEED );
+// starts a new match in one lane, drawing from rngKey
+void ResetLane( BatchState& batch, u32 lane, u64 rngKey );
+
+// references into one lane, for the shared step code in physics.hpp
+MatchRef LaneRef( BatchState& batch, u32 lane );
+
+// puts every match mid rally with a random ball, direction and paddles,
+// about one in ten waiting for the next round, so lanes take different paths
+void ScatterBatch( BatchState& batch, u64 seed );
+
+GameState LoadGameState( const BatchState& batch, u32 lane );
+void StoreGameState( BatchState& batch, u32 lane, const GameState& gameState );
+
+enum SimdLevel {
+    SIMD_SCALAR = 0,
+    SIMD_SSE41,
+    SIMD_AVX2,
+    SIMD_AVX512,
+    SIMD_LEVEL_COUNT
+};
+
+const char* SimdLevelName( SimdLevel level );
+// best instruction set supported by this cpu
+SimdLevel DetectSimdLevel();
+
+// Steps lanes [first, first + count) by ts seconds.
+// inputs is indexed by lane, pass nullptr to let BotInput play the left paddle.
+// Uses the best instruction set available, every level gives identical results.
+void StepBatch( BatchState& batch, u32 first, u32 count, DeltaTime ts, const PlayerInput* inputs );
+// same as StepBatch with an explicit instruction set, level must be supported
+void StepBatchLevel( BatchState& batch, u32 first, u32 count, DeltaTime ts, const PlayerInput* inputs, SimdLevel level );
+
+// Steps every match ticks times, spread over the pool in chunks of grain lanes
+// (rounded to BATCH_LANE_ALIGN). Chunks run all their ticks in one go so the
+// lanes stay in cache, and matches never wait on each other.
+void RunBatch( class JobPool& pool, BatchState& batch, u32 ticks, DeltaTime ts, u32 grain = 1024 );
+
+// StepBatch with StepMatchSwept from analytic.hpp, for steps long enough
+// that the ball would pass through a paddle. time is the game time the step
+// starts at, the same for every lane. Scalar only.
+void StepBatchSwept( BatchState& batch, u32 first, u32 count, f64 time, DeltaTime ts, const PlayerInput* inputs );
+
+// StepBatch with both paddles played from inputs, cpuInputs moves the right one. Scalar only.
+void StepBatchVersus( BatchState& batch, u32 first, u32 count, DeltaTime ts, const PlayerInput* inputs, const PlayerInput* cpuInputs );
+
+// per instruction set kernels, see batch_simd.hpp
+void StepBatchSse41( BatchState& batch, u32 first, u32 count, DeltaTime ts, const PlayerInput* inputs );
+void StepBatchAvx2( BatchState& batch, u32 first, u32 count, DeltaTime ts, const PlayerInput* inputs );
+void StepBatchAvx512( BatchState& batch, u32 first, u32 count, DeltaTime ts, const PlayerInput* inputs );
@@ -0,0 +1,65 @@
+#include "batch.hpp"
+// shared inline code must be seen before the target pragma,
+// otherwise its out of line copies could be built for this instruction set
+#include "./core/physics.hpp"
+#include <immintrin.h>
+
+// fma is left out on purpose, contracting mul + add would break parity with the scalar path
+#pragma GCC target("avx2")
+
+struct SimdAvx2 {
+    typedef __m256  Float;
+    typedef __m256i Int;
+    typedef __m256  Mask;
+    static const u32 WIDTH = 8;
+
+    static Float Set(f32 v)                 { return _mm256_set1_ps(v); }
+    static Float Load(const f32* p)         { return _mm256_loadu_ps(p); }
+    static void  Store(f32* p, Float v)     { _mm256_storeu_ps(p, v); }
+    static Int   LoadInt(const u32* p)      { return _mm256_loadu_si256((const __m256i*)p); }
+    static void  StoreInt(u32* p, Int v)    { _mm256_storeu_si256((__m256i*)p, v); }
+    static Mask  LoadMask(const bool* p) {
+        __m256i wide = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)p));
+        return _mm256_castsi256_ps(_mm256_cmpgt_epi32(wide, _mm256_setzero_si256()));
+    }
+    static void StoreMask(bool* p, Mask m) {
+        u32 bits = Bits(m);
+        for( u32 i = 0; i < WIDTH; i++ ) { p[i] = (bits >> i) & 1; }
+    }
+
+    static Float Add(Float a, Float b)  { return _mm256_add_ps(a, b); }
+    static Float Sub(Float a, Float b)  { return _mm256_sub_ps(a, b); }
+    static Float Mul(Float a, Float b)  { return _mm256_mul_ps(a, b); }
+    static Float Div(Float a, Float b)  { return _mm256_div_ps(a, b); }
+    static Float Sqrt(Float a)          { return _mm256_sqrt_ps(a); }
+    static Float Neg(Float a)           { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+    static Float Abs(Float a)           { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static Float Min(Float a, Float b)  { return _mm256_min_ps(a, b); }
+    static Float Max(Float a, Float b)  { return _mm256_max_ps(a, b); }
+
+    static Mask Lt(Float a, Float b)    { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static Mask Le(Float a, Float b)    { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static Mask Gt(Float a, Float b)    { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static Mask Ge(Float a, Float b)    { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static Mask And(Mask a, Mask b)     { return _mm256_and_ps(a, b); }
+    static Mask Or(Mask a, Mask b)      { return _mm256_or_ps(a, b); }
+    static Mask AndNot(Mask a, Mask b)  { return _mm256_andnot_ps(b, a); }
+    static Mask Not(Mask a)             { return _mm256_xor_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+    static u32  Bits(Mask m)            { return (u32)_mm256_movemask_ps(m); }
+
+    static Float Select(Mask m, Float a, Float b) { return _mm256_blendv_ps(b, a, m); }
+    // mask lanes are all ones, subtracting them adds one
+    static Int Increment(Int v, Mask m) { return _mm256_sub_epi32(v, _mm256_castps_si256(m)); }
+    static Int IncrementAll(Int v)      { return _mm256_add_epi32(v, _mm256_set1_epi32(1)); }
+
+    static Int   SetInt(u32 v)              { return _mm256_set1_epi32((i32)v); }
+    static Int   AndInt(Int a, Int b)       { return _mm256_and_si256(a, b); }
+    static Int   FloorToInt(Float a)        { return _mm256_cvttps_epi32(_mm256_floor_ps(a)); }
+    static Float Gather(const f32* table, Int index) { return _mm256_i32gather_ps(table, index, 4); }
+};
+
+#include "batch_simd.hpp"
+
+void StepBatchAvx2( BatchState& batch, u32 first, u32 count, DeltaTime ts, const PlayerInput* inputs ) {
+    StepLanes<SimdAvx2>( batch, first, count, ts, inputs );
+}
@@ -0,0 +1,72 @@
+// ignore compiler warning
+// gcc 12 flags the _mm512_undefined_* placeholders used inside its own intrinsics
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include "batch.hpp"
+// shared inline code must be seen before the target pragma,
+// otherwise its out of line copies could be built for this instruction set
+#include "./core/physics.hpp"
+#include <immintrin.h>
+
+// avx512f implies fma, stop gcc from contracting mul + add
+// into fused instructions, that would break parity with the scalar path
+#pragma GCC target("avx512f")
+#pragma GCC optimize("fp-contract=off")
+
+struct SimdAvx512 {
+    typedef __m512    Float;
+    typedef __m512i   Int;
+    typedef __mmask16 Mask;
+    static const u32 WIDTH = 16;
+
+    static Float Set(f32 v)                 { return _mm512_set1_ps(v); }
+    static Float Load(const f32* p)         { return _mm512_loadu_ps(p); }
+    static void  Store(f32* p, Float v)     { _mm512_storeu_ps(p, v); }
+    static Int   LoadInt(const u32* p)      { return _mm512_loadu_si512(p); }
+    static void  StoreInt(u32* p, Int v)    { _mm512_storeu_si512(p, v); }
+    static Mask  LoadMask(const bool* p) {
+        __m512i wide = _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)p));
+        return _mm512_test_epi32_mask(wide, wide);
+    }
+    static void StoreMask(bool* p, Mask m) {
+        _mm_storeu_si128((__m128i*)p, _mm512_cvtepi32_epi8(_mm512_maskz_set1_epi32(m, 1)));
+    }
+
+    static Float Add(Float a, Float b)  { return _mm512_add_ps(a, b); }
+    static Float Sub(Float a, Float b)  { return _mm512_sub_ps(a, b); }
+    static Float Mul(Float a, Float b)  { return _mm512_mul_ps(a, b); }
+    static Float Div(Float a, Float b)  { return _mm512_div_ps(a, b); }
+    static Float Sqrt(Float a)          { return _mm512_sqrt_ps(a); }
+    static Float Neg(Float a) {
+        return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_set1_epi32((i32)0x80000000)));
+    }
+    static Float Abs(Float a)           { return _mm512_abs_ps(a); }
+    static Float Min(Float a, Float b)  { return _mm512_min_ps(a, b); }
+    static Float Max(Float a, Float b)  { return _mm512_max_ps(a, b); }
+
+    static Mask Lt(Float a, Float b)    { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static Mask Le(Float a, Float b)    { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+    static Mask Gt(Float a, Float b)    { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static Mask Ge(Float a, Float b)    { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+    static Mask And(Mask a, Mask b)     { return a & b; }
+    static Mask Or(Mask a, Mask b)      { return a | b; }
+    static Mask AndNot(Mask a, Mask b)  { return a & ~b; }
+    static Mask Not(Mask a)             { return (Mask)~a; }
+    static u32  Bits(Mask m)            { return (u32)m; }
+
+    static Float Select(Mask m, Float a, Float b) { return _mm512_mask_blend_ps(m, b, a); }
+    static Int Increment(Int v, Mask m) { return _mm512_mask_add_epi32(v, m, v, _mm512_set1_epi32(1)); }
+    static Int IncrementAll(Int v)      { return _mm512_add_epi32(v, _mm512_set1_epi32(1)); }
+
+    static Int   SetInt(u32 v)              { return _mm512_set1_epi32((i32)v); }
+    static Int   AndInt(Int a, Int b)       { return _mm512_and_si512(a, b); }
+    static Int   FloorToInt(Float a) {
+        return _mm512_cvttps_epi32(_mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+    }
+    static Float Gather(const f32* table, Int index) { return _mm512_i32gather_ps(index, table, 4); }
+};
+
+#include "batch_simd.hpp"
+
+void StepBatchAvx512( BatchState& batch, u32 first, u32 count, DeltaTime ts, const PlayerInput* inputs ) {
+    StepLanes<SimdAvx512>( batch, first, count, ts, inputs );
+}
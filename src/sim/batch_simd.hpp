@@ -0,0 +1,180 @@
+#pragma once
+// Vectorized StepBatch kernel, written once against a small set of SIMD traits.
+// Included by one translation unit per instruction set, after that unit has
+// selected its target with #pragma GCC target, so every instantiation is compiled
+// for exactly one ISA. Results match StepMatch lane for lane: every lane performs
+// the same float operations in the same order and branches are replaced by masks.
+// The middle-third bounce is drawn per lane from the lane's counter based rng.
+// The cpu's intercept comes from INTERCEPT_TABLE with a gather.
+#include "batch.hpp"
+#include "./core/physics.hpp"
+
+template<typename S>
+void StepLanes( BatchState& batch, u32 first, u32 count, DeltaTime ts, const PlayerInput* inputs ) {
+    typedef typename S::Float F;
+    typedef typename S::Int   I;
+    typedef typename S::Mask  M;
+
+    const F tsV           = S::Set(ts);
+    const F zero          = S::Set(0.0f);
+    const F one           = S::Set(1.0f);
+    const GameRules& rules = batch.rules;
+    const F ballSpeed     = S::Set(rules.ballSpeed);
+    const F paddleSpeed   = S::Set(rules.paddleSpeed);
+    const F cpuSpeed      = S::Set(rules.cpuSpeed);
+    const F ballHalf      = S::Set(rules.BallHalfSize());
+    const F paddleHalfH   = S::Set(rules.PaddleHalfH());
+    const F thirdHalf     = S::Set(rules.PaddleThirdH() / 2.0f);
+    const F bounceMax     = S::Set(rules.bounceMax);
+    const F fieldW        = S::Set(rules.fieldW);
+    const F fieldH        = S::Set(rules.fieldH);
+    const F delay         = S::Set(rules.delayBetweenRounds);
+    const F reactX        = S::Set(CPU_REACT_X);
+    const F playerLeft    = S::Set(-rules.paddleX - rules.PaddleHalfW());
+    const F playerRight   = S::Set(-rules.paddleX + rules.PaddleHalfW());
+    const F cpuLeft       = S::Set(rules.paddleX - rules.PaddleHalfW());
+    const F cpuRight      = S::Set(rules.paddleX + rules.PaddleHalfW());
+    const F interceptX      = S::Set(CpuInterceptX(rules));
+    const F interceptRange  = S::Set(InterceptRange(rules));
+    const F interceptScale  = S::Set(InterceptScale(rules));
+    const F interceptOffset = S::Set(InterceptOffset(rules));
+    const F interceptLimit  = S::Set(INTERCEPT_LIMIT);
+    const F aimSlack        = S::Set(CpuAimSlack(rules));
+    const F aimX            = S::Set(rules.cpuAimX);
+    const I binMask         = S::SetInt(INTERCEPT_BINS - 1);
+
+    u32 last = first + count;
+    u32 lane = first;
+    for( ; lane + S::WIDTH <= last; lane += S::WIDTH ) {
+        F ballX   = S::Load(batch.ballX + lane);
+        F ballY   = S::Load(batch.ballY + lane);
+        F dirX    = S::Load(batch.dirX + lane);
+        F dirY    = S::Load(batch.dirY + lane);
+        F playerY = S::Load(batch.playerY + lane);
+        F cpuY    = S::Load(batch.cpuY + lane);
+        F timer   = S::Load(batch.scoreTimer + lane);
+        I playerScore = S::LoadInt(batch.playerScore + lane);
+        I cpuScore    = S::LoadInt(batch.cpuScore + lane);
+        I tick        = S::LoadInt(batch.tick + lane);
+        M scored      = S::LoadMask(batch.scored + lane);
+
+        // player paddle direction, sampled before anything moves
+        F playerDY;
+        if( inputs ) {
+            f32 dy[S::WIDTH];
+            for( u32 i = 0; i < S::WIDTH; i++ ) { dy[i] = PlayerDY(inputs[lane + i]); }
+            playerDY = S::Load(dy);
+        } else {
+            M active = S::Not( S::Gt(ballX, S::Neg(reactX)) );
+            M up     = S::And( active, S::Gt(ballY, S::Add(playerY, paddleHalfH)) );
+            M down   = S::And( active, S::Lt(ballY, S::Sub(playerY, paddleHalfH)) );
+            playerDY = S::Select( up, one, S::Select(down, S::Neg(one), zero) );
+        }
+
+        M play = S::Not(scored);
+
+        // MoveBallX
+        F resultX  = S::Add( ballX, S::Mul(S::Mul(dirX, tsV), ballSpeed) );
+        M outLeft  = S::Le( S::Add(resultX, ballHalf), S::Neg(fieldW) );
+        M outRight = S::Ge( S::Sub(resultX, ballHalf), fieldW );
+        M out      = S::Or(outLeft, outRight);
+        M newPoint = S::And(play, out);
+        cpuScore    = S::Increment( cpuScore,    S::And(newPoint, outLeft) );
+        playerScore = S::Increment( playerScore, S::AndNot(S::And(newPoint, outRight), outLeft) );
+        ballX = S::Select( S::AndNot(play, out), resultX, ballX );
+
+        // MoveBallY
+        F resultY   = S::Add( ballY, S::Mul(S::Mul(dirY, tsV), ballSpeed) );
+        M hitTop    = S::Ge( S::Add(resultY, ballHalf), fieldH );
+        M hitBottom = S::AndNot( S::Le(S::Sub(resultY, ballHalf), S::Neg(fieldH)), hitTop );
+        F absDirY   = S::Abs(dirY);
+        dirY  = S::Select( S::And(play, hitTop), S::Neg(absDirY), dirY );
+        dirY  = S::Select( S::And(play, hitBottom), absDirY, dirY );
+        ballY = S::Select( S::AndNot(play, S::Or(hitTop, hitBottom)), resultY, ballY );
+
+        // BallCollision
+        F left   = S::Sub(ballX, ballHalf);
+        F right  = S::Add(ballX, ballHalf);
+        F top    = S::Add(ballY, ballHalf);
+        F bottom = S::Sub(ballY, ballHalf);
+
+        M hitPlayer = S::And( S::Le(bottom, S::Add(playerY, paddleHalfH)), S::Ge(top, S::Sub(playerY, paddleHalfH)) );
+        hitPlayer   = S::And( hitPlayer, S::And(S::Le(left, playerRight), S::Ge(right, playerLeft)) );
+        hitPlayer   = S::And( play, hitPlayer );
+        M hitCpu    = S::And( S::Le(bottom, S::Add(cpuY, paddleHalfH)), S::Ge(top, S::Sub(cpuY, paddleHalfH)) );
+        hitCpu      = S::And( hitCpu, S::And(S::Le(left, cpuRight), S::Ge(right, cpuLeft)) );
+        hitCpu      = S::And( play, hitCpu );
+        M bounce    = S::Or(hitPlayer, hitCpu);
+
+        dirX = S::Select( hitPlayer, one, dirX );
+        dirX = S::Select( hitCpu, S::Neg(one), dirX );
+
+        F paddleY = S::Select( hitCpu, cpuY, playerY );
+        M topThird    = S::Gt( ballY, S::Add(paddleY, thirdHalf) );
+        M bottomThird = S::Lt( ballY, S::Sub(paddleY, thirdHalf) );
+
+        F bounceY = zero;
+        u32 middle = S::Bits( S::AndNot(S::AndNot(bounce, topThird), bottomThird) );
+        if( middle ) {
+            f32 random[S::WIDTH] = {};
+            for( u32 i = 0; i < S::WIDTH; i++ ) {
+                if( middle & (1u << i) ) { random[i] = MiddleBounce(batch.rngKey[lane + i], batch.tick[lane + i]); }
+            }
+            bounceY = S::Load(random);
+        }
+        bounceY = S::Select( topThird, bounceMax, S::Select(bottomThird, S::Neg(bounceMax), bounceY) );
+        dirY    = S::Select( bounce, bounceY, dirY );
+
+        F invLength = S::Div( one, S::Sqrt(S::Add(S::Mul(dirX, dirX), S::Mul(dirY, dirY))) );
+        dirX = S::Select( bounce, S::Mul(dirX, invLength), dirX );
+        dirY = S::Select( bounce, S::Mul(dirY, invLength), dirY );
+
+        // waiting between rounds
+        F nextTimer = S::Add(timer, tsV);
+        M reset     = S::And( scored, S::Ge(nextTimer, delay) );
+        timer  = S::Select( scored, S::Select(reset, zero, nextTimer), timer );
+        ballX  = S::Select( reset, zero, ballX );
+        ballY  = S::Select( reset, zero, ballY );
+        dirX   = S::Select( reset, S::Neg(dirX), dirX );
+        dirY   = S::Select( reset, zero, dirY );
+        scored = S::Or( S::AndNot(scored, reset), newPoint );
+
+        // paddles
+        F nextPlayerY = S::Add( playerY, S::Mul(S::Mul(paddleSpeed, playerDY), tsV) );
+        M playerStuck = S::Or( S::Ge(S::Add(nextPlayerY, paddleHalfH), fieldH), S::Le(S::Sub(nextPlayerY, paddleHalfH), S::Neg(fieldH)) );
+        playerY = S::Select( playerStuck, playerY, nextPlayerY );
+
+        // InterceptY, lanes with the ball going away divide by one instead,
+        // they and lanes the cpu isn't aiming in yet head for the middle
+        M cpuToward = S::Gt(dirX, zero);
+        F unfolded  = S::Mul( S::Div(dirY, S::Select(cpuToward, dirX, one)), S::Sub(interceptX, ballX) );
+        unfolded    = S::Add( S::Add(ballY, unfolded), interceptOffset );
+        unfolded    = S::Min( S::Max(unfolded, S::Neg(interceptLimit)), interceptLimit );
+        I bin       = S::AndInt( S::FloorToInt(S::Mul(unfolded, interceptScale)), binMask );
+        F target    = S::Mul( S::Gather(INTERCEPT_TABLE.y, bin), interceptRange );
+        target      = S::Select( S::And(cpuToward, S::Gt(ballX, aimX)), target, zero );
+        M cpuUp     = S::Gt( target, S::Add(cpuY, aimSlack) );
+        M cpuDown   = S::Lt( target, S::Sub(cpuY, aimSlack) );
+        F cpuDY     = S::Select( cpuUp, cpuSpeed, S::Select(cpuDown, S::Neg(cpuSpeed), zero) );
+        F nextCpuY  = S::Add( cpuY, S::Mul(cpuDY, tsV) );
+        M cpuStuck  = S::Or( S::Ge(S::Add(nextCpuY, paddleHalfH), fieldH), S::Le(S::Sub(nextCpuY, paddleHalfH), S::Neg(fieldH)) );
+        cpuY = S::Select( cpuStuck, cpuY, nextCpuY );
+
+        S::Store(batch.ballX + lane, ballX);
+        S::Store(batch.ballY + lane, ballY);
+        S::Store(batch.dirX + lane, dirX);
+        S::Store(batch.dirY + lane, dirY);
+        S::Store(batch.playerY + lane, playerY);
+        S::Store(batch.cpuY + lane, cpuY);
+        S::Store(batch.scoreTimer + lane, timer);
+        S::StoreInt(batch.playerScore + lane, playerScore);
+        S::StoreInt(batch.cpuScore + lane, cpuScore);
+        S::StoreInt(batch.tick + lane, S::IncrementAll(tick));
+        S::StoreMask(batch.scored + lane, scored);
+    }
+
+    // remaining lanes that don't fill a register
+    if( lane < last ) {
+        StepBatchLevel( batch, lane, last - lane, ts, inputs, SimdLevel::SIMD_SCALAR );
+    }
+}
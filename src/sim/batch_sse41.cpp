@@ -0,0 +1,71 @@
+#include "batch.hpp"
+// shared inline code must be seen before the target pragma,
+// otherwise its out of line copies could be built for this instruction set
+#include "./core/physics.hpp"
+#include <immintrin.h>
+
+#pragma GCC target("sse4.1")
+
+struct SimdSse41 {
+    typedef __m128  Float;
+    typedef __m128i Int;
+    typedef __m128  Mask;
+    static const u32 WIDTH = 4;
+
+    static Float Set(f32 v)                 { return _mm_set1_ps(v); }
+    static Float Load(const f32* p)         { return _mm_loadu_ps(p); }
+    static void  Store(f32* p, Float v)     { _mm_storeu_ps(p, v); }
+    static Int   LoadInt(const u32* p)      { return _mm_loadu_si128((const __m128i*)p); }
+    static void  StoreInt(u32* p, Int v)    { _mm_storeu_si128((__m128i*)p, v); }
+    static Mask  LoadMask(const bool* p) {
+        i32 bytes;
+        __builtin_memcpy(&bytes, p, sizeof(bytes));
+        __m128i wide = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes));
+        return _mm_castsi128_ps(_mm_cmpgt_epi32(wide, _mm_setzero_si128()));
+    }
+    static void StoreMask(bool* p, Mask m) {
+        u32 bits = Bits(m);
+        for( u32 i = 0; i < WIDTH; i++ ) { p[i] = (bits >> i) & 1; }
+    }
+
+    static Float Add(Float a, Float b)  { return _mm_add_ps(a, b); }
+    static Float Sub(Float a, Float b)  { return _mm_sub_ps(a, b); }
+    static Float Mul(Float a, Float b)  { return _mm_mul_ps(a, b); }
+    static Float Div(Float a, Float b)  { return _mm_div_ps(a, b); }
+    static Float Sqrt(Float a)          { return _mm_sqrt_ps(a); }
+    static Float Neg(Float a)           { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+    static Float Abs(Float a)           { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static Float Min(Float a, Float b)  { return _mm_min_ps(a, b); }
+    static Float Max(Float a, Float b)  { return _mm_max_ps(a, b); }
+
+    static Mask Lt(Float a, Float b)    { return _mm_cmplt_ps(a, b); }
+    static Mask Le(Float a, Float b)    { return _mm_cmple_ps(a, b); }
+    static Mask Gt(Float a, Float b)    { return _mm_cmpgt_ps(a, b); }
+    static Mask Ge(Float a, Float b)    { return _mm_cmpge_ps(a, b); }
+    static Mask And(Mask a, Mask b)     { return _mm_and_ps(a, b); }
+    static Mask Or(Mask a, Mask b)      { return _mm_or_ps(a, b); }
+    static Mask AndNot(Mask a, Mask b)  { return _mm_andnot_ps(b, a); }
+    static Mask Not(Mask a)             { return _mm_xor_ps(a, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+    static u32  Bits(Mask m)            { return (u32)_mm_movemask_ps(m); }
+
+    static Float Select(Mask m, Float a, Float b) { return _mm_blendv_ps(b, a, m); }
+    // mask lanes are all ones, subtracting them adds one
+    static Int Increment(Int v, Mask m) { return _mm_sub_epi32(v, _mm_castps_si128(m)); }
+    static Int IncrementAll(Int v)      { return _mm_add_epi32(v, _mm_set1_epi32(1)); }
+
+    static Int   SetInt(u32 v)              { return _mm_set1_epi32((i32)v); }
+    static Int   AndInt(Int a, Int b)       { return _mm_and_si128(a, b); }
+    static Int   FloorToInt(Float a)        { return _mm_cvttps_epi32(_mm_floor_ps(a)); }
+    // no gather before avx2
+    static Float Gather(const f32* table, Int index) {
+        i32 i[WIDTH];
+        _mm_storeu_si128((__m128i*)i, index);
+        return _mm_setr_ps(table[i[0]], table[i[1]], table[i[2]], table[i[3]]);
+    }
+};
+
+#include "batch_simd.hpp"
+
+void StepBatchSse41( BatchState& batch, u32 first, u32 count, DeltaTime ts, const PlayerInput* inputs ) {
+    StepLanes<SimdSse41>( batch, first, count, ts, inputs );
+}
@@ -0,0 +1,66 @@
+#include "file.hpp"
+#include <cstdio>
+
+#ifdef WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile MapFile( const char* path ) {
+    MappedFile result = {};
+#ifdef WINDOWS
+    HANDLE fileHandle = CreateFileA(
+        path, GENERIC_READ, FILE_SHARE_READ,
+        NULL, OPEN_EXISTING, 0, 0
+    );
+    if( fileHandle == INVALID_HANDLE_VALUE ) { return result; }
+
+    LARGE_INTEGER fileSize;
+    if( GetFileSizeEx(fileHandle, &fileSize) == TRUE && fileSize.QuadPart > 0 ) {
+        HANDLE mapping = CreateFileMappingA( fileHandle, NULL, PAGE_READONLY, 0, 0, NULL );
+        if( mapping ) {
+            result.data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+            result.size = (size_t)fileSize.QuadPart;
+            // the view keeps the mapping alive
+            CloseHandle( mapping );
+        }
+    }
+    CloseHandle( fileHandle );
+    if( !result.data ) { result = {}; }
+#else
+    int fd = open( path, O_RDONLY );
+    if( fd < 0 ) { return result; }
+    struct stat info;
+    if( fstat(fd, &info) == 0 && info.st_size > 0 ) {
+        void* data = mmap( nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if( data != MAP_FAILED ) {
+            result.data = data;
+            result.size = (size_t)info.st_size;
+        }
+    }
+    close( fd );
+#endif
+    return result;
+}
+
+void UnmapFile( MappedFile& file ) {
+    if( file.data ) {
+#ifdef WINDOWS
+        UnmapViewOfFile( file.data );
+#else
+        munmap( (void*)file.data, file.size );
+#endif
+    }
+    file = {};
+}
+
+bool WriteEntireFile( const char* path, const void* data, size_t size ) {
+    FILE* file = fopen( path, "wb" );
+    if( !file ) { return false; }
+    bool written = fwrite( data, 1, size, file ) == size;
+    return fclose( file ) == 0 && written;
+}
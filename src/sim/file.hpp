@@ -0,0 +1,16 @@
+#pragma once
+#include "defines.hpp"
+#include <cstddef>
+
+// read only view of a whole file mapped into memory
+struct MappedFile {
+    const void* data;
+    size_t size;
+    void* handle;
+};
+
+// data is nullptr if the file couldn't be mapped
+MappedFile MapFile( const char* path );
+void UnmapFile( MappedFile& file );
+
+bool WriteEntireFile( const char* path, const void* data, size_t size );
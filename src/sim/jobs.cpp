@@ -0,0 +1,158 @@
+#include "jobs.hpp"
+#include "./core/profile.hpp"
+
+#ifdef WINDOWS
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// index of the calling thread's queue, workers set it on start up
+thread_local u32 t_queueIndex = ~0u;
+thread_local JobPool* t_pool  = nullptr;
+
+u32 CoreCount() {
+    u32 cores = std::thread::hardware_concurrency();
+    return cores ? cores : 1;
+}
+
+void PinThreadToCore( u32 core ) {
+#ifdef WINDOWS
+    SetThreadAffinityMask( GetCurrentThread(), (DWORD_PTR)1 << (core % (sizeof(DWORD_PTR) * 8)) );
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    pthread_setaffinity_np( pthread_self(), sizeof(set), &set );
+#else
+    (void)core;
+#endif
+}
+
+JobPool::JobPool( u32 workerCount, bool pinThreads ) {
+    if( workerCount == JOB_POOL_ALL_CORES ) { workerCount = CoreCount() - 1; }
+    for( u32 i = 0; i < workerCount + 1; i++ ) {
+        m_queues.push_back( new WorkerQueue() );
+    }
+    for( u32 i = 0; i < workerCount; i++ ) {
+        m_workers.emplace_back( &JobPool::WorkerMain, this, i, pinThreads );
+    }
+}
+
+JobPool::~JobPool() {
+    {
+        std::lock_guard<std::mutex> guard(m_sleepLock);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for( std::thread& worker : m_workers ) { worker.join(); }
+    for( WorkerQueue* queue : m_queues ) { delete queue; }
+}
+
+void JobPool::Submit( const Job& job ) {
+    // workers keep what they spawn, everyone else spreads jobs over the queues
+    u32 index = t_pool == this ? t_queueIndex :
+        m_nextQueue.fetch_add(1, std::memory_order_relaxed) % (u32)m_queues.size();
+    {
+        WorkerQueue* queue = m_queues[index];
+        std::lock_guard<std::mutex> guard(queue->lock);
+        queue->jobs.push_back(job);
+    }
+    m_queued.fetch_add(1, std::memory_order_release);
+    {
+        // taking the lock orders this with a worker about to sleep
+        std::lock_guard<std::mutex> guard(m_sleepLock);
+    }
+    m_wake.notify_one();
+}
+
+bool JobPool::TakeJob( u32 self, Job& job ) {
+    if( m_queued.load(std::memory_order_acquire) == 0 ) { return false; }
+    u32 queueCount = (u32)m_queues.size();
+
+    // newest job from our own queue first, it's the most likely to be in cache
+    if( self < queueCount ) {
+        WorkerQueue* queue = m_queues[self];
+        std::lock_guard<std::mutex> guard(queue->lock);
+        if( !queue->jobs.empty() ) {
+            job = queue->jobs.back();
+            queue->jobs.pop_back();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    // steal the oldest job of someone else, usually the biggest piece left
+    for( u32 offset = 1; offset <= queueCount; offset++ ) {
+        u32 victim = (self + offset) % queueCount;
+        if( victim == self ) { continue; }
+        WorkerQueue* queue = m_queues[victim];
+        std::lock_guard<std::mutex> guard(queue->lock);
+        if( !queue->jobs.empty() ) {
+            job = queue->jobs.front();
+            queue->jobs.pop_front();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobPool::RunJob( const Job& job ) {
+    PROFILE_ZONE("Job");
+    job.function( job.user, job.first, job.count );
+    if( job.counter ) {
+        job.counter->remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+void JobPool::WorkerMain( u32 index, bool pin ) {
+    // core 0 is left to the thread that owns the pool
+    if( pin ) { PinThreadToCore( (index + 1) % CoreCount() ); }
+    t_queueIndex = index;
+    t_pool       = this;
+    PROFILE_THREAD_NAME("Job Worker");
+
+    Job job;
+    while( true ) {
+        if( TakeJob(index, job) ) {
+            RunJob(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(m_sleepLock);
+        m_wake.wait( guard, [this]() {
+            return m_stop.load() || m_queued.load(std::memory_order_acquire) > 0;
+        } );
+        if( m_stop.load() && m_queued.load() == 0 ) { return; }
+    }
+}
+
+void JobPool::Wait( JobCounter& counter ) {
+    u32 self = t_pool == this ? t_queueIndex : (u32)m_workers.size();
+    Job job;
+    while( counter.remaining.load(std::memory_order_acquire) > 0 ) {
+        if( TakeJob(self, job) ) {
+            RunJob(job);
+        } else {
+            // whatever is left is running on other threads
+            std::this_thread::yield();
+        }
+    }
+}
+
+void ParallelFor( JobPool& pool, u32 count, u32 grain, JobFunction function, void* user ) {
+    if( count == 0 ) { return; }
+    if( grain == 0 ) { grain = 1; }
+    JobCounter counter;
+    counter.remaining = (count + grain - 1) / grain;
+    for( u32 first = 0; first < count; first += grain ) {
+        Job job = {};
+        job.function = function;
+        job.user     = user;
+        job.first    = first;
+        job.count    = count - first < grain ? count - first : grain;
+        job.counter  = &counter;
+        pool.Submit(job);
+    }
+    pool.Wait(counter);
+}
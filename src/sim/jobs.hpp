@@ -0,0 +1,77 @@
+#pragma once
+#include "defines.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// one worker per core, minus the thread that submits and waits
+const u32 JOB_POOL_ALL_CORES = ~0u;
+
+typedef void (*JobFunction)(void* user, u32 first, u32 count);
+
+// counts unfinished jobs of one submission, see JobPool::Wait
+struct JobCounter {
+    std::atomic<u32> remaining{0};
+};
+
+struct Job {
+    JobFunction function;
+    void* user;
+    u32 first;
+    u32 count;
+    JobCounter* counter;
+};
+
+// Work stealing thread pool.
+// Every worker owns a deque, it pushes and pops its own jobs at the back and steals
+// from the front of the others' when it runs dry, so long running jobs don't leave
+// the rest of the cores idle at the end of a batch. Threads that wait on a counter
+// run jobs while they wait, so jobs can submit and wait on more jobs.
+class JobPool {
+public:
+    // workerCount threads are started, pinned threads stay on core (index % cores).
+    // The thread calling Wait works too, so the default leaves one core for it.
+    JobPool( u32 workerCount = JOB_POOL_ALL_CORES, bool pinThreads = true );
+    ~JobPool();
+    JobPool( const JobPool& ) = delete;
+    JobPool& operator=( const JobPool& ) = delete;
+
+    void Submit( const Job& job );
+    // runs jobs until every job counted by counter is done
+    void Wait( JobCounter& counter );
+    u32 WorkerCount() { return (u32)m_workers.size(); }
+private:
+    struct WorkerQueue {
+        std::mutex lock;
+        std::deque<Job> jobs;
+    };
+
+    void WorkerMain( u32 index, bool pin );
+    bool TakeJob( u32 self, Job& job );
+    void RunJob( const Job& job );
+
+    std::vector<std::thread> m_workers;
+    // one queue per worker plus one for threads outside the pool
+    std::vector<WorkerQueue*> m_queues;
+    std::atomic<u32> m_queued{0};
+    std::atomic<u32> m_nextQueue{0};
+    std::atomic<bool> m_stop{false};
+    std::mutex m_sleepLock;
+    std::condition_variable m_wake;
+};
+
+// cores on this machine, at least 1
+u32 CoreCount();
+
+// splits [0, count) into jobs of at most grain items and waits for all of them
+void ParallelFor( JobPool& pool, u32 count, u32 grain, JobFunction function, void* user );
+
+template<typename F>
+void ParallelFor( JobPool& pool, u32 count, u32 grain, const F& function ) {
+    ParallelFor( pool, count, grain, []( void* user, u32 first, u32 count ) {
+        (*(const F*)user)( first, count );
+    }, (void*)&function );
+}
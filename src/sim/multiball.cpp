@@ -0,0 +1,307 @@
+#include "multiball.hpp"
+#include "jobs.hpp"
+#include <cmath>
+#include <new>
+#include <utility>
+
+const size_t MULTI_BALL_MEMORY_ALIGN = 64;
+
+f32 MultiBallSize( u32 count, f32 fill, const GameRules& rules ) {
+    f32 area = 4.0f * rules.fieldW * rules.fieldH;
+    return sqrtf( area * fill / (f32)(count ? count : 1) );
+}
+
+MultiBallState CreateMultiBall( u32 count, f32 ballSize, u64 seed ) {
+    MultiBallState result = {};
+    result.count = count;
+    result.rules = DEFAULT_RULES;
+    result.rules.ballSize = ballSize;
+    result.rngKey = MatchRngKey( seed, 0 );
+
+    // about one ball per cell, never smaller than a ball so touching balls
+    // are always in neighbouring cells
+    const GameRules& rules = result.rules;
+    f32 area = 4.0f * rules.fieldW * rules.fieldH;
+    result.cellSize = fmaxf( ballSize, sqrtf(area / (f32)(count ? count : 1)) );
+    result.gridW = (u32)fmaxf( floorf(2.0f * rules.fieldW / result.cellSize), 1.0f );
+    result.gridH = (u32)fmaxf( floorf(2.0f * rules.fieldH / result.cellSize), 1.0f );
+    u32 cells = result.gridW * result.gridH;
+    u32 jobs  = (count + MULTI_BALL_GRAIN - 1) / MULTI_BALL_GRAIN;
+
+    auto aligned = []( size_t size ) {
+        return (size + MULTI_BALL_MEMORY_ALIGN - 1) / MULTI_BALL_MEMORY_ALIGN * MULTI_BALL_MEMORY_ALIGN;
+    };
+    size_t ballArray   = aligned( sizeof(f32) * count );
+    size_t cellArray   = aligned( sizeof(std::atomic<u32>) * (cells + 1) );
+    size_t targetArray = sizeof(MultiBallTarget) * 2 * jobs;
+    size_t size = ballArray * 12 + cellArray + targetArray;
+
+    result.memory = ::operator new( size, std::align_val_t(MULTI_BALL_MEMORY_ALIGN) );
+
+    u8* cursor = (u8*)result.memory;
+    result.targets = (MultiBallTarget*)cursor; cursor += targetArray;
+    for( MultiBallArrays& balls : result.balls ) {
+        balls.x  = (f32*)cursor; cursor += ballArray;
+        balls.y  = (f32*)cursor; cursor += ballArray;
+        balls.vx = (f32*)cursor; cursor += ballArray;
+        balls.vy = (f32*)cursor; cursor += ballArray;
+    }
+    result.nextVX = (f32*)cursor; cursor += ballArray;
+    result.nextVY = (f32*)cursor; cursor += ballArray;
+    result.cell   = (u32*)cursor; cursor += ballArray;
+    result.order  = (u32*)cursor; cursor += ballArray;
+    result.cellStart = (std::atomic<u32>*)cursor;
+    for( u32 i = 0; i <= cells; i++ ) { new (&result.cellStart[i]) std::atomic<u32>(0); }
+
+    MultiBallArrays& balls = result.balls[0];
+    for( u32 i = 0; i < count; i++ ) {
+        u64 key = MatchRngKey( seed, i + 1 );
+        u32 draw = 0;
+        auto next = [key, &draw]() {
+            return (f32)(Squares32(draw++, key) >> 8) / (f32)(1u << 24);
+        };
+        // clear of the paddles so nothing starts inside one
+        f32 spanX = rules.paddleX - rules.PaddleHalfW() - ballSize;
+        f32 spanY = rules.fieldH - ballSize;
+        f32 angle = next() * 6.2831853f;
+        balls.x[i]  = (next() * 2.0f - 1.0f) * spanX;
+        balls.y[i]  = (next() * 2.0f - 1.0f) * spanY;
+        balls.vx[i] = cosf(angle) * rules.ballSpeed;
+        balls.vy[i] = sinf(angle) * rules.ballSpeed;
+    }
+    return result;
+}
+
+void FreeMultiBall( MultiBallState& state ) {
+    if(state.memory) {
+        ::operator delete( state.memory, std::align_val_t(MULTI_BALL_MEMORY_ALIGN) );
+    }
+    state = {};
+}
+
+u32 CellOf( const MultiBallState& state, f32 x, f32 y ) {
+    i32 cx = (i32)floorf( (x + state.rules.fieldW) / state.cellSize );
+    i32 cy = (i32)floorf( (y + state.rules.fieldH) / state.cellSize );
+    // balls past the paddles or on a wall go in the edge cells
+    cx = cx < 0 ? 0 : (cx >= (i32)state.gridW ? (i32)state.gridW - 1 : cx);
+    cy = cy < 0 ? 0 : (cy >= (i32)state.gridH ? (i32)state.gridH - 1 : cy);
+    return (u32)cy * state.gridW + (u32)cx;
+}
+
+// sends a ball back off a paddle at its speed, the part of the paddle it hit sets the angle
+void PaddleBounceBall( const MultiBallState& state, f32 y, f32 paddleY, f32 dirX, u32 ball, f32& vx, f32& vy ) {
+    const GameRules& rules = state.rules;
+    f32 speed = sqrtf( vx * vx + vy * vy );
+    f32 dirY;
+    if( y > paddleY + rules.PaddleThirdH() / 2.0f ) {
+        dirY = rules.bounceMax;
+    } else if( y < paddleY - rules.PaddleThirdH() / 2.0f ) {
+        dirY = -rules.bounceMax;
+    } else {
+        dirY = MiddleBounce( state.rngKey, state.tick * 31u + ball );
+    }
+    f32 scale = speed / sqrtf( 1.0f + dirY * dirY );
+    vx = dirX * scale;
+    vy = dirY * scale;
+}
+
+// moves balls [first, first + count) of the front set and bins them,
+// keeping the ball each paddle has to reach next
+void MoveBalls( MultiBallState& state, u32 first, u32 count, DeltaTime ts, u32& playerPoints, u32& cpuPoints ) {
+    const GameRules& rules = state.rules;
+    MultiBallArrays& balls = state.balls[state.front];
+    const f32 ballHalf = rules.BallHalfSize();
+    const f32 reachW   = rules.PaddleHalfW() + ballHalf;
+    const f32 reachH   = rules.PaddleHalfH() + ballHalf;
+    const f32 top      = rules.fieldH - ballHalf;
+    const f32 goal     = rules.fieldW + ballHalf;
+
+    MultiBallTarget& player = state.targets[first / MULTI_BALL_GRAIN * 2];
+    MultiBallTarget& cpu    = state.targets[first / MULTI_BALL_GRAIN * 2 + 1];
+    player.time = INFINITY;
+    cpu.time    = INFINITY;
+
+    for( u32 i = first; i < first + count; i++ ) {
+        f32 x  = balls.x[i] + balls.vx[i] * ts;
+        f32 y  = balls.y[i] + balls.vy[i] * ts;
+        f32 vx = balls.vx[i];
+        f32 vy = balls.vy[i];
+
+        if( y > top )  { y =  2.0f * top - y; vy = -fabsf(vy); }
+        if( y < -top ) { y = -2.0f * top - y; vy =  fabsf(vy); }
+
+        if( vx < 0.0f && fabsf(x + rules.paddleX) <= reachW && fabsf(y - state.playerY) <= reachH ) {
+            PaddleBounceBall( state, y, state.playerY, 1.0f, i, vx, vy );
+        } else if( vx > 0.0f && fabsf(x - rules.paddleX) <= reachW && fabsf(y - state.cpuY) <= reachH ) {
+            PaddleBounceBall( state, y, state.cpuY, -1.0f, i, vx, vy );
+        }
+
+        // scored, served again from a random height on the center line
+        if( fabsf(x) >= goal ) {
+            if( x < 0.0f ) { cpuPoints++; } else { playerPoints++; }
+            u64 counter = (u64)state.tick << 32 | i;
+            f32 height = (f32)(Squares32(counter, state.rngKey) >> 8) / (f32)(1u << 24);
+            vx = x < 0.0f ? rules.ballSpeed : -rules.ballSpeed;
+            vy = 0.0f;
+            x  = 0.0f;
+            y  = (height * 2.0f - 1.0f) * top;
+        }
+
+        balls.x[i]  = x;
+        balls.y[i]  = y;
+        balls.vx[i] = vx;
+        balls.vy[i] = vy;
+
+        if( vx < 0.0f ) {
+            f32 time = (x + rules.paddleX) / -vx;
+            if( time >= 0.0f && time < player.time ) { player = { time, x, y, vx, vy }; }
+        } else if( vx > 0.0f ) {
+            f32 time = (rules.paddleX - x) / vx;
+            if( time >= 0.0f && time < cpu.time ) { cpu = { time, x, y, vx, vy }; }
+        }
+
+        u32 cell = CellOf( state, x, y );
+        state.cell[i] = cell;
+        state.cellStart[cell].fetch_add( 1, std::memory_order_relaxed );
+    }
+}
+
+// new velocity of sorted ball i after bouncing off every ball it touches,
+// written to nextVX and nextVY so every ball reads the same old velocities
+u32 CollideBall( MultiBallState& state, u32 i ) {
+    const MultiBallArrays& balls = state.balls[state.front];
+    const f32 size   = state.rules.ballSize;
+    const f32 maxSpeed = MULTI_BALL_MAX_SPEED * state.rules.ballSpeed;
+    f32 x  = balls.x[i];
+    f32 y  = balls.y[i];
+    f32 vx = balls.vx[i];
+    f32 vy = balls.vy[i];
+    f32 dvx = 0.0f;
+    f32 dvy = 0.0f;
+    u32 contacts = 0;
+
+    u32 cell = CellOf( state, x, y );
+    i32 cx = (i32)(cell % state.gridW);
+    i32 cy = (i32)(cell / state.gridW);
+    for( i32 ny = cy - 1; ny <= cy + 1; ny++ ) {
+        if( ny < 0 || ny >= (i32)state.gridH ) { continue; }
+        // the three cells of a row are contiguous in sorted order
+        i32 left  = cx > 0 ? cx - 1 : 0;
+        i32 right = cx + 1 < (i32)state.gridW ? cx + 1 : cx;
+        u32 rowFirst = state.cellStart[ny * state.gridW + left].load( std::memory_order_relaxed );
+        u32 rowLast  = state.cellStart[ny * state.gridW + right + 1].load( std::memory_order_relaxed );
+        for( u32 j = rowFirst; j < rowLast; j++ ) {
+            f32 dx = x - balls.x[j];
+            f32 dy = y - balls.y[j];
+            f32 distance2 = dx * dx + dy * dy;
+            if( j == i || distance2 >= size * size || distance2 == 0.0f ) { continue; }
+            // equal masses swap the part of their velocity along the line between them
+            f32 along = (vx - balls.vx[j]) * dx + (vy - balls.vy[j]) * dy;
+            if( along >= 0.0f ) { continue; }
+            f32 scale = along / distance2;
+            dvx -= scale * dx;
+            dvy -= scale * dy;
+            contacts++;
+        }
+    }
+
+    vx += dvx;
+    vy += dvy;
+    f32 speed2 = vx * vx + vy * vy;
+    if( speed2 > maxSpeed * maxSpeed ) {
+        f32 scale = maxSpeed / sqrtf(speed2);
+        vx *= scale;
+        vy *= scale;
+    }
+    state.nextVX[i] = vx;
+    state.nextVY[i] = vy;
+    return contacts;
+}
+
+void StepMultiBall( JobPool& pool, MultiBallState& state, DeltaTime ts ) {
+    const u32 cells = state.gridW * state.gridH;
+    const u32 jobs  = (state.count + MULTI_BALL_GRAIN - 1) / MULTI_BALL_GRAIN;
+
+    // move and count balls per cell
+    std::atomic<u32> playerPoints{0};
+    std::atomic<u32> cpuPoints{0};
+    for( u32 c = 0; c <= cells; c++ ) { state.cellStart[c].store( 0, std::memory_order_relaxed ); }
+    ParallelFor( pool, state.count, MULTI_BALL_GRAIN, [&]( u32 first, u32 count ) {
+        u32 player = 0, cpu = 0;
+        MoveBalls( state, first, count, ts, player, cpu );
+        playerPoints.fetch_add( player, std::memory_order_relaxed );
+        cpuPoints.fetch_add( cpu, std::memory_order_relaxed );
+    } );
+    state.playerScore += playerPoints.load();
+    state.cpuScore    += cpuPoints.load();
+
+    // counts become the end of every cell, each ball then takes the slot
+    // before its cell's end, leaving cellStart at the start of every cell
+    u32 sum = 0;
+    for( u32 c = 0; c < cells; c++ ) {
+        sum += state.cellStart[c].load( std::memory_order_relaxed );
+        state.cellStart[c].store( sum, std::memory_order_relaxed );
+    }
+    state.cellStart[cells].store( sum, std::memory_order_relaxed );
+    ParallelFor( pool, state.count, MULTI_BALL_GRAIN, [&]( u32 first, u32 count ) {
+        for( u32 i = first; i < first + count; i++ ) {
+            u32 slot = state.cellStart[state.cell[i]].fetch_sub( 1, std::memory_order_relaxed ) - 1;
+            state.order[slot] = i;
+        }
+    } );
+
+    // threads take slots in any order, put each cell back in ball order
+    // so the result is the same on any number of threads, then gather
+    MultiBallArrays& from = state.balls[state.front];
+    MultiBallArrays& to   = state.balls[state.front ^ 1];
+    ParallelFor( pool, cells, MULTI_BALL_GRAIN, [&]( u32 first, u32 count ) {
+        for( u32 c = first; c < first + count; c++ ) {
+            u32 begin = state.cellStart[c].load( std::memory_order_relaxed );
+            u32 end   = state.cellStart[c + 1].load( std::memory_order_relaxed );
+            for( u32 a = begin + 1; a < end; a++ ) {
+                u32 ball = state.order[a];
+                u32 b = a;
+                for( ; b > begin && state.order[b - 1] > ball; b-- ) { state.order[b] = state.order[b - 1]; }
+                state.order[b] = ball;
+            }
+        }
+    } );
+    ParallelFor( pool, state.count, MULTI_BALL_GRAIN, [&]( u32 first, u32 count ) {
+        for( u32 slot = first; slot < first + count; slot++ ) {
+            u32 ball = state.order[slot];
+            to.x[slot]  = from.x[ball];
+            to.y[slot]  = from.y[ball];
+            to.vx[slot] = from.vx[ball];
+            to.vy[slot] = from.vy[ball];
+        }
+    } );
+    state.front ^= 1;
+
+    std::atomic<u32> contacts{0};
+    ParallelFor( pool, state.count, MULTI_BALL_GRAIN, [&]( u32 first, u32 count ) {
+        u32 jobContacts = 0;
+        for( u32 i = first; i < first + count; i++ ) { jobContacts += CollideBall( state, i ); }
+        contacts.fetch_add( jobContacts, std::memory_order_relaxed );
+    } );
+    MultiBallArrays& balls = state.balls[state.front];
+    std::swap( balls.vx, state.nextVX );
+    std::swap( balls.vy, state.nextVY );
+    // every touching pair was seen from both balls
+    state.contacts = contacts.load() / 2;
+
+    // paddles play the ball that reaches them first, the player's side mirrored
+    MultiBallTarget player = { INFINITY, 0.0f, 0.0f, 0.0f, 0.0f };
+    MultiBallTarget cpu    = player;
+    for( u32 job = 0; job < jobs; job++ ) {
+        if( state.targets[job * 2].time < player.time )  { player = state.targets[job * 2]; }
+        if( state.targets[job * 2 + 1].time < cpu.time ) { cpu = state.targets[job * 2 + 1]; }
+    }
+    const GameRules& rules = state.rules;
+    f32 playerDY = player.time < INFINITY ? CpuDY( -player.x, player.y, -player.vx, player.vy, state.playerY, rules ) :
+        CpuDY( 0.0f, 0.0f, -1.0f, 0.0f, state.playerY, rules );
+    f32 cpuDY = cpu.time < INFINITY ? CpuDY( cpu.x, cpu.y, cpu.vx, cpu.vy, state.cpuY, rules ) :
+        CpuDY( 0.0f, 0.0f, -1.0f, 0.0f, state.cpuY, rules );
+    state.playerY = MovePaddle( state.playerY, playerDY * ts, rules );
+    state.cpuY    = MovePaddle( state.cpuY, cpuDY * ts, rules );
+    state.tick++;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "defines.hpp"
+#include "./core/physics.hpp"
+#include <atomic>
+
+// One field with thousands to millions of balls bouncing off the walls, the
+// paddles and each other, the stress scene for the collision code.
+// Balls are a structure of arrays that is counting sorted by grid cell every
+// tick, so balls that can touch sit next to each other in memory and a ball
+// only has to look at the cells around its own.
+
+// balls handed to each job
+const u32 MULTI_BALL_GRAIN = 4096;
+// pile ups are resolved all at once and can add energy, nothing goes faster than this
+const f32 MULTI_BALL_MAX_SPEED = 2.0f;
+
+struct MultiBallArrays {
+    f32* x;
+    f32* y;
+    f32* vx;
+    f32* vy;
+};
+
+// the ball closest to reaching a paddle, found by each job and reduced after
+struct alignas(64) MultiBallTarget {
+    f32 time;
+    f32 x;
+    f32 y;
+    f32 vx;
+    f32 vy;
+};
+
+struct MultiBallState {
+    u32 count;
+    // in cell order after every step, the other set is scratch for the sort
+    MultiBallArrays balls[2];
+    u32 front;
+    // cell of every ball, and the ball each sorted slot is taken from
+    u32* cell;
+    u32* order;
+    // velocities after ball to ball collisions
+    f32* nextVX;
+    f32* nextVY;
+
+    // uniform grid over the field, cells are at least one ball wide
+    u32 gridW;
+    u32 gridH;
+    f32 cellSize;
+    // first sorted ball of every cell, gridW * gridH + 1 entries
+    std::atomic<u32>* cellStart;
+
+    // one pair per job, player then cpu
+    MultiBallTarget* targets;
+
+    f32 playerY;
+    f32 cpuY;
+    u32 playerScore;
+    u32 cpuScore;
+    u64 rngKey;
+    u32 tick;
+    // ball pairs that bounced off each other during the last step
+    u32 contacts;
+
+    // rules.ballSize is the size of every ball
+    GameRules rules;
+
+    void* memory;
+};
+
+// balls start spread over the field, moving in random directions at rules.ballSpeed
+MultiBallState CreateMultiBall( u32 count, f32 ballSize, u64 seed = DEFAULT_RNG_SEED );
+void FreeMultiBall( MultiBallState& state );
+// size at which count balls cover about fill of the field
+f32 MultiBallSize( u32 count, f32 fill, const GameRules& rules = DEFAULT_RULES );
+
+// moves every ball, sorts them into the grid and bounces touching balls off
+// each other, spread over the pool. Results don't depend on the thread count.
+void StepMultiBall( class JobPool& pool, MultiBallState& state, DeltaTime ts );
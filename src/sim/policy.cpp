@@ -0,0 +1,58 @@
+#include "policy.hpp"
+#include <cstring>
+
+// ticks between the sloppy policy looking at the ball again
+const u32 SLOPPY_REACTION_TICKS = 12;
+
+const Policy BUILTIN_POLICIES[] = {
+    { "idle",   IdlePolicy },
+    { "chase",  ChasePolicy },
+    { "sloppy", SloppyPolicy },
+    { "cpu",    CpuPolicy },
+};
+const u32 BUILTIN_POLICY_COUNT = sizeof(BUILTIN_POLICIES) / sizeof(BUILTIN_POLICIES[0]);
+
+GameState MirrorGameState( const GameState& state ) {
+    GameState result = state;
+    result.ball.x           = -state.ball.x;
+    result.ball.direction.x = -state.ball.direction.x;
+    result.player           = state.cpu;
+    result.cpu              = state.player;
+    result.playerScore      = state.cpuScore;
+    result.cpuScore         = state.playerScore;
+    return result;
+}
+
+PlayerInput IdlePolicy( const PolicyView& ) {
+    return PlayerInput{};
+}
+
+PlayerInput ChasePolicy( const PolicyView& view ) {
+    return BotInput( view.state.ball.x, view.state.ball.y, view.state.player.y, *view.rules );
+}
+
+PlayerInput SloppyPolicy( const PolicyView& view ) {
+    if( view.tick % SLOPPY_REACTION_TICKS != 0 ) { return view.last; }
+    PlayerInput result = ChasePolicy( view );
+    u32 roll = Squares32( view.tick, view.key ) % 8;
+    if( roll == 0 )      { result.up = !result.up; result.down = false; }
+    else if( roll == 1 ) { result.up = false; result.down = false; }
+    return result;
+}
+
+PlayerInput CpuPolicy( const PolicyView& view ) {
+    // CpuDY plays the right paddle, ask it about the mirror image of this one
+    GameState mirror = MirrorGameState( view.state );
+    f32 dy = CpuDY( mirror.ball.x, mirror.ball.y, mirror.ball.direction.x, mirror.ball.direction.y, mirror.cpu.y, *view.rules );
+    PlayerInput result = {};
+    result.up   = dy > 0.0f;
+    result.down = dy < 0.0f;
+    return result;
+}
+
+const Policy* FindPolicy( const char* name ) {
+    for( u32 i = 0; i < BUILTIN_POLICY_COUNT; i++ ) {
+        if( strcmp(BUILTIN_POLICIES[i].name, name) == 0 ) { return &BUILTIN_POLICIES[i]; }
+    }
+    return nullptr;
+}
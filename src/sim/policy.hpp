@@ -0,0 +1,46 @@
+#pragma once
+#include "defines.hpp"
+#include "./core/physics.hpp"
+
+// Paddle policies for AI vs AI play.
+// A policy always plays the left paddle, the right paddle is played by giving a
+// policy the mirrored match, so every policy can take either side.
+
+struct PolicyView {
+    // the match as seen from the left paddle
+    GameState   state;
+    u32         tick;
+    // rng key of the side this policy is playing, for policies that roll dice
+    u64         key;
+    // what the policy did last tick
+    PlayerInput last;
+    // rules the match is played by
+    const GameRules* rules = &DEFAULT_RULES;
+};
+
+typedef PlayerInput (*PolicyFunction)( const PolicyView& view );
+
+struct Policy {
+    const char*    name;
+    PolicyFunction function;
+};
+
+// the match from the right paddle's side: x flipped and the paddles and scores swapped
+GameState MirrorGameState( const GameState& state );
+
+// never moves
+PlayerInput IdlePolicy( const PolicyView& view );
+// BotInput, the game's original cpu: chases the ball's height once it's close
+PlayerInput ChasePolicy( const PolicyView& view );
+// ChasePolicy with a reaction time and the odd mistake,
+// so inputs change the way a person's do and points actually get scored
+PlayerInput SloppyPolicy( const PolicyView& view );
+// CpuDY's choice of direction at the player's paddle speed, heads for where
+// the ball will cross its paddle once it's past cpuAimX
+PlayerInput CpuPolicy( const PolicyView& view );
+
+extern const Policy BUILTIN_POLICIES[];
+extern const u32 BUILTIN_POLICY_COUNT;
+
+// built in policy with this name, nullptr if there isn't one
+const Policy* FindPolicy( const char* name );
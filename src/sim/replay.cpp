@@ -0,0 +1,202 @@
+#include "replay.hpp"
+#include "statehash.hpp"
+#include <algorithm>
+#include <cstring>
+
+const u32 KEYFRAME_SCORED    = 1 << 0;
+const u32 KEYFRAME_LAST_UP   = 1 << 1;
+const u32 KEYFRAME_LAST_DOWN = 1 << 2;
+const u32 KEYFRAME_SCENE_SHIFT = 8;
+const u32 KEYFRAME_MENU_SHIFT  = 16;
+
+u16 PackInput( const PlayerInput& input ) {
+    return (u16)( (input.up ? 1 : 0) | (input.down ? 2 : 0) | (input.enter ? 4 : 0) );
+}
+
+PlayerInput UnpackInput( u16 bits ) {
+    PlayerInput result = {};
+    result.up    = (bits & 1) != 0;
+    result.down  = (bits & 2) != 0;
+    result.enter = (bits & 4) != 0;
+    return result;
+}
+
+ReplayKeyframe MakeKeyframe( const PongSnapshot& snapshot ) {
+    ReplayKeyframe result = {};
+    result.flags =
+        (snapshot.gameState.scored ? KEYFRAME_SCORED : 0) |
+        (snapshot.lastUp ? KEYFRAME_LAST_UP : 0) |
+        (snapshot.lastDown ? KEYFRAME_LAST_DOWN : 0) |
+        ((u32)snapshot.scene << KEYFRAME_SCENE_SHIFT) |
+        ((u32)snapshot.selectedMenuOption << KEYFRAME_MENU_SHIFT);
+    result.ballX       = snapshot.gameState.ball.x;
+    result.ballY       = snapshot.gameState.ball.y;
+    result.dirX        = snapshot.gameState.ball.direction.x;
+    result.dirY        = snapshot.gameState.ball.direction.y;
+    result.playerY     = snapshot.gameState.player.y;
+    result.cpuY        = snapshot.gameState.cpu.y;
+    result.scoreTimer  = snapshot.scoreTimer;
+    result.playerScore = snapshot.gameState.playerScore;
+    result.cpuScore    = snapshot.gameState.cpuScore;
+    result.pongTick    = snapshot.tick;
+    result.rngKey      = snapshot.rngKey;
+    return result;
+}
+
+PongSnapshot KeyframeSnapshot( const ReplayKeyframe& keyframe ) {
+    PongSnapshot result = {};
+    result.gameState.scored      = (keyframe.flags & KEYFRAME_SCORED) != 0;
+    result.gameState.ball.x      = keyframe.ballX;
+    result.gameState.ball.y      = keyframe.ballY;
+    result.gameState.ball.direction.x = keyframe.dirX;
+    result.gameState.ball.direction.y = keyframe.dirY;
+    result.gameState.player.y    = keyframe.playerY;
+    result.gameState.cpu.y       = keyframe.cpuY;
+    result.gameState.playerScore = keyframe.playerScore;
+    result.gameState.cpuScore    = keyframe.cpuScore;
+    result.scene              = (Scene)((keyframe.flags >> KEYFRAME_SCENE_SHIFT) & 0xff);
+    result.selectedMenuOption = (MenuOption)((keyframe.flags >> KEYFRAME_MENU_SHIFT) & 0xff);
+    result.scoreTimer = keyframe.scoreTimer;
+    result.lastUp     = (keyframe.flags & KEYFRAME_LAST_UP) != 0;
+    result.lastDown   = (keyframe.flags & KEYFRAME_LAST_DOWN) != 0;
+    result.rngKey     = keyframe.rngKey;
+    result.tick       = keyframe.pongTick;
+    return result;
+}
+
+ReplayWriter::ReplayWriter( f32 tickLength, u32 keyframeInterval, u32 hashInterval ) {
+    m_tickLength       = tickLength;
+    m_keyframeInterval = keyframeInterval ? keyframeInterval : REPLAY_DEFAULT_KEYFRAME_INTERVAL;
+    m_hashInterval     = hashInterval ? hashInterval : REPLAY_DEFAULT_HASH_INTERVAL;
+    m_rollingHash      = STATE_HASH_SEED;
+}
+
+void ReplayWriter::Record( const Pong& pong, const PlayerInput& input ) {
+    u16 bits = PackInput(input);
+    if( !m_runs.empty() &&
+        (m_runs.back() & ((1 << REPLAY_INPUT_BITS) - 1)) == bits &&
+        (m_runs.back() >> REPLAY_INPUT_BITS) < REPLAY_MAX_RUN - 1
+    ) {
+        m_runs.back() += 1 << REPLAY_INPUT_BITS;
+    } else {
+        m_runs.push_back(bits);
+    }
+
+    PongSnapshot snapshot;
+    pong.SaveSnapshot(snapshot);
+    m_rollingHash = RollHash( m_rollingHash, HashPongState(snapshot) );
+    if( m_tickCount % m_hashInterval == 0 ) {
+        m_hashes.push_back( m_rollingHash );
+    }
+
+    if( m_tickCount % m_keyframeInterval == 0 ) {
+        ReplayKeyframe keyframe = MakeKeyframe(snapshot);
+        keyframe.tick      = m_tickCount;
+        keyframe.run       = (u32)m_runs.size() - 1;
+        keyframe.runOffset = m_runs.back() >> REPLAY_INPUT_BITS;
+        m_keyframes.push_back(keyframe);
+    }
+    m_tickCount++;
+}
+
+void ReplayWriter::Finish( const Pong& pong ) {
+    PongSnapshot snapshot;
+    pong.SaveSnapshot(snapshot);
+    m_finalHash = RollHash( m_rollingHash, HashPongState(snapshot) );
+}
+
+u32 AlignReplayOffset( u32 offset ) { return (offset + 7) & ~7u; }
+
+std::vector<u8> ReplayWriter::Serialize() const {
+    ReplayHeader header = {};
+    header.magic            = REPLAY_MAGIC;
+    header.version          = REPLAY_VERSION;
+    header.headerSize       = sizeof(ReplayHeader);
+    header.tickLength       = m_tickLength;
+    header.tickCount        = m_tickCount;
+    header.keyframeInterval = m_keyframeInterval;
+    header.keyframeCount    = (u32)m_keyframes.size();
+    header.runCount         = (u32)m_runs.size();
+    header.keyframesOffset  = AlignReplayOffset( sizeof(ReplayHeader) );
+    header.runsOffset       = header.keyframesOffset + header.keyframeCount * sizeof(ReplayKeyframe);
+    header.hashInterval     = m_hashInterval;
+    header.hashCount        = (u32)m_hashes.size();
+    header.hashesOffset     = AlignReplayOffset( header.runsOffset + header.runCount * sizeof(u16) );
+    header.finalHash        = m_finalHash;
+
+    std::vector<u8> result( header.hashesOffset + header.hashCount * sizeof(u64) );
+    memcpy( result.data(), &header, sizeof(header) );
+    if( !m_keyframes.empty() ) {
+        memcpy( result.data() + header.keyframesOffset, m_keyframes.data(), m_keyframes.size() * sizeof(ReplayKeyframe) );
+    }
+    if( !m_runs.empty() ) {
+        memcpy( result.data() + header.runsOffset, m_runs.data(), m_runs.size() * sizeof(u16) );
+    }
+    if( !m_hashes.empty() ) {
+        memcpy( result.data() + header.hashesOffset, m_hashes.data(), m_hashes.size() * sizeof(u64) );
+    }
+    return result;
+}
+
+bool OpenReplay( const void* data, size_t size, ReplayView& view ) {
+    view = {};
+    if( !data || size < sizeof(ReplayHeader) ) { return false; }
+    const ReplayHeader* header = (const ReplayHeader*)data;
+    if( header->magic != REPLAY_MAGIC || header->version != REPLAY_VERSION ||
+        header->headerSize != sizeof(ReplayHeader) ) { return false; }
+    if( header->keyframesOffset % 8 != 0 || header->runsOffset % 2 != 0 || header->hashesOffset % 8 != 0 ) { return false; }
+    if( header->hashInterval == 0 ) { return false; }
+    if( (size_t)header->keyframesOffset + (size_t)header->keyframeCount * sizeof(ReplayKeyframe) > size ) { return false; }
+    if( (size_t)header->runsOffset + (size_t)header->runCount * sizeof(u16) > size ) { return false; }
+    if( (size_t)header->hashesOffset + (size_t)header->hashCount * sizeof(u64) > size ) { return false; }
+
+    view.header    = header;
+    view.keyframes = (const ReplayKeyframe*)((const u8*)data + header->keyframesOffset);
+    view.runs      = (const u16*)((const u8*)data + header->runsOffset);
+    view.hashes    = (const u64*)((const u8*)data + header->hashesOffset);
+    return true;
+}
+
+const ReplayKeyframe* FindKeyframe( const ReplayView& view, u32 tick ) {
+    const ReplayKeyframe* first = view.keyframes;
+    const ReplayKeyframe* last  = view.keyframes + view.header->keyframeCount;
+    const ReplayKeyframe* after = std::upper_bound( first, last, tick,
+        []( u32 value, const ReplayKeyframe& keyframe ) { return value < keyframe.tick; }
+    );
+    return after == first ? nullptr : after - 1;
+}
+
+ReplayCursor KeyframeCursor( const ReplayKeyframe& keyframe ) {
+    ReplayCursor result = {};
+    result.tick      = keyframe.tick;
+    result.run       = keyframe.run;
+    result.runOffset = keyframe.runOffset;
+    return result;
+}
+
+PlayerInput NextInput( const ReplayView& view, ReplayCursor& cursor ) {
+    if( cursor.run >= view.header->runCount ) { return PlayerInput{}; }
+    u16 run = view.runs[cursor.run];
+    PlayerInput result = UnpackInput( run & ((1 << REPLAY_INPUT_BITS) - 1) );
+    cursor.tick++;
+    cursor.runOffset++;
+    if( cursor.runOffset > (u32)(run >> REPLAY_INPUT_BITS) ) {
+        cursor.run++;
+        cursor.runOffset = 0;
+    }
+    return result;
+}
+
+bool SeekReplay( const ReplayView& view, u32 tick, Pong& pong, ReplayCursor& cursor ) {
+    if( tick > view.header->tickCount ) { return false; }
+    const ReplayKeyframe* keyframe = FindKeyframe( view, tick );
+    if( !keyframe ) { return false; }
+
+    pong.RestoreSnapshot( KeyframeSnapshot(*keyframe) );
+    cursor = KeyframeCursor(*keyframe);
+    while( cursor.tick < tick ) {
+        PlayerInput input = NextInput( view, cursor );
+        pong.UpdateGame( view.header->tickLength, input );
+    }
+    return true;
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include "defines.hpp"
+#include "./core/app.hpp"
+#include <cstddef>
+#include <vector>
+
+// Replay file layout, little endian, every section aligned so a mapped file
+// can be read in place:
+//   ReplayHeader
+//   ReplayKeyframe[keyframeCount]   full state every keyframeInterval ticks
+//   u16[runCount]                   run length encoded inputs
+//   u64[hashCount]                  rolling state hash every hashInterval ticks
+// An input run packs the input bits (up, down, enter) into the low 3 bits
+// and the number of ticks it lasts, minus one, into the high 13.
+// Tick t of a replay is the t-th UpdateGame call after recording started.
+// Hash i is the rolling hash (see statehash.hpp) of the states before ticks
+// 0 to i * hashInterval, finalHash also covers the state after the last tick.
+
+const u32 REPLAY_MAGIC   = 0x4c505250; // "PRPL"
+const u16 REPLAY_VERSION = 3;
+const u32 REPLAY_DEFAULT_KEYFRAME_INTERVAL = 1200;
+const u32 REPLAY_DEFAULT_HASH_INTERVAL     = 120;
+const u32 REPLAY_INPUT_BITS = 3;
+const u32 REPLAY_MAX_RUN    = 1 << (16 - REPLAY_INPUT_BITS);
+
+struct ReplayHeader {
+    u32 magic;
+    u16 version;
+    u16 headerSize;
+    f32 tickLength;
+    u32 tickCount;
+    u32 keyframeInterval;
+    u32 keyframeCount;
+    u32 runCount;
+    u32 keyframesOffset;
+    u32 runsOffset;
+    u32 hashInterval;
+    u32 hashCount;
+    u32 hashesOffset;
+    u32 flags;
+    u64 finalHash;
+};
+
+struct ReplayKeyframe {
+    u32 tick;
+    // where the input for tick is in the runs
+    u32 run;
+    u32 runOffset;
+    // scored, lastUp, lastDown, scene and menu option, see MakeKeyframe
+    u32 flags;
+    f32 ballX;
+    f32 ballY;
+    f32 dirX;
+    f32 dirY;
+    f32 playerY;
+    f32 cpuY;
+    f32 scoreTimer;
+    u32 playerScore;
+    u32 cpuScore;
+    u32 pongTick;
+    u64 rngKey;
+};
+
+u16 PackInput( const PlayerInput& input );
+PlayerInput UnpackInput( u16 bits );
+
+ReplayKeyframe MakeKeyframe( const PongSnapshot& snapshot );
+PongSnapshot KeyframeSnapshot( const ReplayKeyframe& keyframe );
+
+class ReplayWriter {
+public:
+    ReplayWriter(
+        f32 tickLength,
+        u32 keyframeInterval = REPLAY_DEFAULT_KEYFRAME_INTERVAL,
+        u32 hashInterval     = REPLAY_DEFAULT_HASH_INTERVAL
+    );
+    // call right before each UpdateGame with the pong about to be stepped and its input
+    void Record( const Pong& pong, const PlayerInput& input );
+    // call after the last UpdateGame
+    void Finish( const Pong& pong );
+    u32 TickCount() const { return m_tickCount; }
+    // the finished replay file
+    std::vector<u8> Serialize() const;
+private:
+    f32 m_tickLength;
+    u32 m_keyframeInterval;
+    u32 m_hashInterval;
+    u32 m_tickCount = 0;
+    u64 m_rollingHash;
+    u64 m_finalHash = 0;
+    std::vector<ReplayKeyframe> m_keyframes;
+    std::vector<u16> m_runs;
+    std::vector<u64> m_hashes;
+};
+
+// points into a replay's memory, usually a mapped file
+struct ReplayView {
+    const ReplayHeader*   header;
+    const ReplayKeyframe* keyframes;
+    const u16*            runs;
+    const u64*            hashes;
+};
+
+// position in the input runs
+struct ReplayCursor {
+    u32 tick;
+    u32 run;
+    u32 runOffset;
+};
+
+// false if data isn't a valid replay
+bool OpenReplay( const void* data, size_t size, ReplayView& view );
+// nearest keyframe at or before tick, binary search
+const ReplayKeyframe* FindKeyframe( const ReplayView& view, u32 tick );
+ReplayCursor KeyframeCursor( const ReplayKeyframe& keyframe );
+// input for cursor.tick, then moves the cursor to the next tick
+PlayerInput NextInput( const ReplayView& view, ReplayCursor& cursor );
+// Puts pong in the state right before tick is simulated by restoring the nearest
+// keyframe and simulating forward from it. cursor is left at tick.
+bool SeekReplay( const ReplayView& view, u32 tick, Pong& pong, ReplayCursor& cursor );
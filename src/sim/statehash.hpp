@@ -0,0 +1,49 @@
+#pragma once
+#include "defines.hpp"
+#include "./core/app.hpp"
+#include <cstring>
+
+const u64 STATE_HASH_SEED = 0xcbf29ce484222325ull;
+
+inline u64 MixHash( u64 h, u64 value ) {
+    h ^= value + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
+
+inline u64 FloatBits( f32 value ) {
+    u32 bits;
+    memcpy( &bits, &value, sizeof(bits) );
+    return bits;
+}
+
+// fixed point values hash by their raw bits
+inline u64 FloatBits( Fixed value ) {
+    return (u32)value.raw;
+}
+
+// Hash of everything that decides how a match plays out. Floats are hashed
+// by their bits, so any difference at all shows up.
+template<typename Real>
+inline u64 HashPongState( const BasicGameState<Real>& state, Real scoreTimer, u32 tick ) {
+    u64 h = STATE_HASH_SEED;
+    h = MixHash( h, FloatBits(state.ball.x) | FloatBits(state.ball.y) << 32 );
+    h = MixHash( h, FloatBits(state.ball.direction.x) | FloatBits(state.ball.direction.y) << 32 );
+    h = MixHash( h, FloatBits(state.player.y) | FloatBits(state.cpu.y) << 32 );
+    h = MixHash( h, (u64)state.playerScore | (u64)state.cpuScore << 32 );
+    h = MixHash( h, FloatBits(scoreTimer) | (u64)tick << 32 );
+    h = MixHash( h, (u64)state.scored );
+    return h;
+}
+
+template<typename Real>
+inline u64 HashPongState( const BasicPongSnapshot<Real>& snapshot ) {
+    return HashPongState( snapshot.gameState, snapshot.scoreTimer, snapshot.tick );
+}
+
+// folds one tick's state hash into the hash of every tick before it
+inline u64 RollHash( u64 rolling, u64 stateHash ) {
+    return MixHash( rolling, stateHash );
+}
@@ -0,0 +1,155 @@
+#include "sweep.hpp"
+#include <cstdio>
+#include <cstring>
+
+const char* SWEEP_PARAM_NAMES[SWEEP_PARAM_COUNT] = {
+    "ballSpeed",
+    "paddleSpeed",
+    "bounceMax",
+    "delay",
+    "ballSize",
+    "paddleH",
+    "cpuAimX",
+};
+
+const char* SweepParamName( SweepParam param ) {
+    return SWEEP_PARAM_NAMES[param];
+}
+
+bool FindSweepParam( const char* name, SweepParam& param ) {
+    for( u32 i = 0; i < SWEEP_PARAM_COUNT; i++ ) {
+        if( strcmp(SWEEP_PARAM_NAMES[i], name) == 0 ) {
+            param = (SweepParam)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+f32& RulesField( GameRules& rules, SweepParam param ) {
+    switch( param ) {
+        case SWEEP_BALL_SPEED:   return rules.ballSpeed;
+        case SWEEP_PADDLE_SPEED: return rules.paddleSpeed;
+        case SWEEP_BOUNCE_MAX:   return rules.bounceMax;
+        case SWEEP_DELAY:        return rules.delayBetweenRounds;
+        case SWEEP_BALL_SIZE:    return rules.ballSize;
+        case SWEEP_PADDLE_H:     return rules.paddleH;
+        case SWEEP_CPU_AIM_X:    return rules.cpuAimX;
+        default:                 return rules.ballSpeed;
+    }
+}
+
+bool ParseSweepAxis( const char* text, SweepAxis& axis ) {
+    char name[32] = {};
+    f32 low = 0.0f, high = 0.0f;
+    u32 steps = 1;
+    int read = sscanf( text, "%31[^=]=%f:%f:%u", name, &low, &high, &steps );
+    if( read < 2 || !FindSweepParam(name, axis.param) ) { return false; }
+    if( read == 2 ) { high = low; }
+    axis.low   = low;
+    axis.high  = high;
+    axis.steps = steps ? steps : 1;
+    return true;
+}
+
+std::vector<GameRules> GridPoints( const std::vector<SweepAxis>& axes ) {
+    std::vector<GameRules> result( 1, GameRules{} );
+    for( const SweepAxis& axis : axes ) {
+        std::vector<GameRules> next;
+        for( const GameRules& rules : result ) {
+            for( u32 step = 0; step < axis.steps; step++ ) {
+                f32 t = axis.steps > 1 ? (f32)step / (f32)(axis.steps - 1) : 0.0f;
+                GameRules point = rules;
+                RulesField( point, axis.param ) = axis.low + (axis.high - axis.low) * t;
+                next.push_back( point );
+            }
+        }
+        result.swap( next );
+    }
+    return result;
+}
+
+std::vector<GameRules> RandomPoints( const std::vector<SweepAxis>& axes, u32 count, u64 seed ) {
+    std::vector<GameRules> result( count );
+    u64 key = MatchRngKey( seed, ~0u );
+    u64 draw = 0;
+    for( GameRules& rules : result ) {
+        for( const SweepAxis& axis : axes ) {
+            f32 t = (f32)(Squares32(draw++, key) >> 8) / (f32)(1u << 24);
+            RulesField( rules, axis.param ) = axis.low + (axis.high - axis.low) * t;
+        }
+    }
+    return result;
+}
+
+void AccumulateStats( SweepStats& total, const SweepStats& part ) {
+    total.ticks        += part.ticks;
+    total.playTicks    += part.playTicks;
+    total.hits         += part.hits;
+    total.tunnels      += part.tunnels;
+    total.playerPoints += part.playerPoints;
+    total.cpuPoints    += part.cpuPoints;
+}
+
+void PlaySweepChunk( BatchState& batch, u32 first, u32 count, u32 ticks, DeltaTime ts,
+    const Policy& left, const Policy& right, SweepStats& stats ) {
+    const GameRules& rules = batch.rules;
+    const f32 reachX = rules.PaddleHalfW() + rules.BallHalfSize();
+    const f32 reachY = rules.PaddleHalfH() + rules.BallHalfSize();
+
+    // where every ball was before the tick, to see what it did during it
+    std::vector<f32> lastX( count ), lastDirX( count );
+    std::vector<bool> lastScored( count );
+    // indexed by lane like StepBatchVersus wants, only [first, first + count) is used
+    std::vector<PlayerInput> leftInputs( first + count ), rightInputs( first + count );
+    // each side rolls its own dice, as in a tournament
+    std::vector<u64> leftKeys( count ), rightKeys( count );
+    u64 startPlayer = 0, startCpu = 0;
+    for( u32 i = 0; i < count; i++ ) {
+        startPlayer += batch.playerScore[first + i];
+        startCpu    += batch.cpuScore[first + i];
+        leftKeys[i]  = MatchRngKey( batch.rngKey[first + i] ^ 0x1ef7, first + i );
+        rightKeys[i] = MatchRngKey( batch.rngKey[first + i] ^ 0x5167, first + i );
+    }
+
+    for( u32 tick = 0; tick < ticks; tick++ ) {
+        for( u32 i = 0; i < count; i++ ) {
+            lastX[i]      = batch.ballX[first + i];
+            lastDirX[i]   = batch.dirX[first + i];
+            lastScored[i] = batch.scored[first + i];
+
+            u32 lane = first + i;
+            GameState state = LoadGameState( batch, lane );
+            u32 tick = batch.tick[lane];
+            leftInputs[lane]  = left.function( PolicyView{ state, tick, leftKeys[i], leftInputs[lane], &rules } );
+            rightInputs[lane] = right.function( PolicyView{ MirrorGameState(state), tick, rightKeys[i], rightInputs[lane], &rules } );
+        }
+        StepBatchVersus( batch, first, count, ts, leftInputs.data(), rightInputs.data() );
+
+        for( u32 i = 0; i < count; i++ ) {
+            u32 lane = first + i;
+            if( lastScored[i] || batch.scored[lane] ) { continue; }
+            stats.playTicks++;
+            if( (batch.dirX[lane] > 0.0f) != (lastDirX[i] > 0.0f) ) {
+                stats.hits++;
+                continue;
+            }
+            // jumped from in front of a paddle to behind it in line with it
+            f32 x = batch.ballX[lane];
+            f32 y = batch.ballY[lane];
+            bool throughCpu = lastX[i] < rules.paddleX - reachX && x > rules.paddleX + reachX &&
+                fabsf(y - batch.cpuY[lane]) <= reachY;
+            bool throughPlayer = lastX[i] > -rules.paddleX + reachX && x < -rules.paddleX - reachX &&
+                fabsf(y - batch.playerY[lane]) <= reachY;
+            if( throughCpu || throughPlayer ) { stats.tunnels++; }
+        }
+    }
+
+    stats.ticks += (u64)ticks * count;
+    for( u32 i = 0; i < count; i++ ) {
+        stats.playerPoints += batch.playerScore[first + i];
+        stats.cpuPoints    += batch.cpuScore[first + i];
+    }
+    stats.playerPoints -= startPlayer;
+    stats.cpuPoints    -= startCpu;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "defines.hpp"
+#include "batch.hpp"
+#include "policy.hpp"
+#include <vector>
+
+// Sweeps over GameRules: many AI vs AI matches between two policies from
+// policy.hpp for every set of rules, reduced to a few balance metrics.
+
+enum SweepParam {
+    SWEEP_BALL_SPEED = 0,
+    SWEEP_PADDLE_SPEED,
+    SWEEP_BOUNCE_MAX,
+    SWEEP_DELAY,
+    SWEEP_BALL_SIZE,
+    SWEEP_PADDLE_H,
+    SWEEP_CPU_AIM_X,
+    SWEEP_PARAM_COUNT
+};
+
+const char* SweepParamName( SweepParam param );
+// false if name isn't one of the SweepParamName names
+bool FindSweepParam( const char* name, SweepParam& param );
+f32& RulesField( GameRules& rules, SweepParam param );
+
+// steps evenly spaced values from low to high
+struct SweepAxis {
+    SweepParam param;
+    f32 low;
+    f32 high;
+    u32 steps;
+};
+
+// parses name=low:high:steps, steps defaults to 1 (just low)
+bool ParseSweepAxis( const char* text, SweepAxis& axis );
+// every combination of the axes' values, parameters without an axis keep their default
+std::vector<GameRules> GridPoints( const std::vector<SweepAxis>& axes );
+// count rules with every axis drawn uniformly from [low, high]
+std::vector<GameRules> RandomPoints( const std::vector<SweepAxis>& axes, u32 count, u64 seed );
+
+// Sums over some lanes. Each job fills its own, padded to a cache line so
+// jobs on different cores never share one, and they're added up at the end.
+struct alignas(64) SweepStats {
+    u64 ticks;
+    // ticks the ball was moving
+    u64 playTicks;
+    u64 hits;
+    // times the ball went through a paddle in one tick without bouncing
+    u64 tunnels;
+    // points won by the left and the right policy
+    u64 playerPoints;
+    u64 cpuPoints;
+};
+
+void AccumulateStats( SweepStats& total, const SweepStats& part );
+// plays lanes [first, first + count) for ticks with left and right at the paddles,
+// adding what happened to stats
+void PlaySweepChunk( BatchState& batch, u32 first, u32 count, u32 ticks, DeltaTime ts,
+    const Policy& left, const Policy& right, SweepStats& stats );
@@ -0,0 +1,158 @@
+#include "tournament.hpp"
+#include <algorithm>
+#include <cmath>
+
+const f64 GLICKO_Q = 0.0057564627324851142; // ln(10) / 400
+const f64 PI_F64   = 3.14159265358979323846;
+
+GameResult PlayGame( const Policy& left, const Policy& right, const GameSettings& settings, u32 id ) {
+    Pong pong( settings.seed, id );
+    PlayerInput start = {};
+    start.enter = true;
+    pong.UpdateMenu( start );
+
+    // each side rolls its own dice
+    u64 leftKey  = MatchRngKey( settings.seed ^ 0x1ef7, id );
+    u64 rightKey = MatchRngKey( settings.seed ^ 0x5167, id );
+    PlayerInput leftInput  = {};
+    PlayerInput rightInput = {};
+
+    GameResult result = {};
+    result.id = id;
+    u32 tick = 0;
+    for( ; tick < settings.maxTicks; tick++ ) {
+        const GameState& state = pong.GetGameState();
+        if( state.playerScore >= settings.targetScore || state.cpuScore >= settings.targetScore ) { break; }
+        leftInput  = left.function( PolicyView{ state, tick, leftKey, leftInput } );
+        rightInput = right.function( PolicyView{ MirrorGameState(state), tick, rightKey, rightInput } );
+        pong.UpdateGame( settings.tickLength, leftInput, rightInput );
+    }
+
+    const GameState& state = pong.GetGameState();
+    result.leftScore  = state.playerScore;
+    result.rightScore = state.cpuScore;
+    result.ticks      = tick;
+    return result;
+}
+
+f64 LeftGameScore( const GameResult& game ) {
+    if( game.leftScore > game.rightScore ) { return 1.0; }
+    if( game.leftScore < game.rightScore ) { return 0.0; }
+    return 0.5;
+}
+
+Rating InitialRating() {
+    Rating result = {};
+    result.elo    = RATING_INITIAL;
+    result.glicko = RATING_INITIAL;
+    result.rd     = GLICKO_INITIAL_RD;
+    return result;
+}
+
+f64 TournamentPoints( const Rating& rating ) {
+    return rating.wins + rating.draws * 0.5;
+}
+
+void UpdateElo( std::vector<Rating>& ratings, const GameResult& game ) {
+    Rating& left  = ratings[game.left];
+    Rating& right = ratings[game.right];
+    f64 expected = 1.0 / (1.0 + pow(10.0, (right.elo - left.elo) / 400.0));
+    f64 change   = ELO_K * (LeftGameScore(game) - expected);
+    left.elo  += change;
+    right.elo -= change;
+}
+
+// how much a game against an opponent with this deviation says
+f64 GlickoG( f64 rd ) {
+    return 1.0 / sqrt(1.0 + 3.0 * GLICKO_Q * GLICKO_Q * rd * rd / (PI_F64 * PI_F64));
+}
+
+f64 GlickoExpected( f64 rating, f64 opponent, f64 opponentRD ) {
+    return 1.0 / (1.0 + pow(10.0, -GlickoG(opponentRD) * (rating - opponent) / 400.0));
+}
+
+void UpdateGlicko( std::vector<Rating>& ratings, const GameResult* games, u32 count ) {
+    // sums over the period per entrant, ratings only change once it's over
+    std::vector<f64> variance( ratings.size() );
+    std::vector<f64> improvement( ratings.size() );
+    auto add = [&]( u32 self, u32 opponent, f64 score ) {
+        const Rating& them = ratings[opponent];
+        f64 g = GlickoG( them.rd );
+        f64 e = GlickoExpected( ratings[self].glicko, them.glicko, them.rd );
+        variance[self]    += g * g * e * (1.0 - e);
+        improvement[self] += g * (score - e);
+    };
+    for( u32 i = 0; i < count; i++ ) {
+        const GameResult& game = games[i];
+        f64 score = LeftGameScore(game);
+        add( game.left, game.right, score );
+        add( game.right, game.left, 1.0 - score );
+
+        if( score == 1.0 )      { ratings[game.left].wins++;   ratings[game.right].losses++; }
+        else if( score == 0.0 ) { ratings[game.left].losses++; ratings[game.right].wins++; }
+        else                    { ratings[game.left].draws++;  ratings[game.right].draws++; }
+    }
+
+    for( size_t i = 0; i < ratings.size(); i++ ) {
+        if( variance[i] <= 0.0 ) { continue; }
+        Rating& rating = ratings[i];
+        f64 inverseDSquared = GLICKO_Q * GLICKO_Q * variance[i];
+        f64 precision = 1.0 / (rating.rd * rating.rd) + inverseDSquared;
+        rating.glicko += GLICKO_Q / precision * improvement[i];
+        rating.rd      = sqrt(1.0 / precision);
+    }
+}
+
+void GlickoInterval( const Rating& rating, f64& low, f64& high ) {
+    low  = rating.glicko - 1.96 * rating.rd;
+    high = rating.glicko + 1.96 * rating.rd;
+}
+
+std::vector<Pairing> RoundRobinPairings( u32 entrants, u32 gamesPerPair ) {
+    std::vector<Pairing> result;
+    for( u32 a = 0; a < entrants; a++ ) {
+        for( u32 b = a + 1; b < entrants; b++ ) {
+            for( u32 game = 0; game < gamesPerPair; game++ ) {
+                if( game % 2 == 0 ) { result.push_back( Pairing{ a, b } ); }
+                else { result.push_back( Pairing{ b, a } ); }
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<Pairing> SwissPairings( const std::vector<Rating>& ratings, std::vector<u8>& met, u32 gamesPerPair ) {
+    u32 entrants = (u32)ratings.size();
+    std::vector<u32> order( entrants );
+    for( u32 i = 0; i < entrants; i++ ) { order[i] = i; }
+    std::stable_sort( order.begin(), order.end(), [&ratings]( u32 a, u32 b ) {
+        f64 pointsA = TournamentPoints( ratings[a] );
+        f64 pointsB = TournamentPoints( ratings[b] );
+        if( pointsA != pointsB ) { return pointsA > pointsB; }
+        return ratings[a].glicko > ratings[b].glicko;
+    } );
+
+    std::vector<Pairing> result;
+    std::vector<bool> paired( entrants );
+    for( u32 i = 0; i < entrants; i++ ) {
+        u32 a = order[i];
+        if( paired[a] ) { continue; }
+        // closest one down that hasn't been met, or just the closest once everyone has
+        u32 opponent = entrants;
+        for( u32 j = i + 1; j < entrants; j++ ) {
+            u32 b = order[j];
+            if( paired[b] ) { continue; }
+            if( opponent == entrants ) { opponent = b; }
+            if( !met[a * entrants + b] ) { opponent = b; break; }
+        }
+        if( opponent == entrants ) { break; }
+
+        paired[a] = paired[opponent] = true;
+        met[a * entrants + opponent] = met[opponent * entrants + a] = 1;
+        for( u32 game = 0; game < gamesPerPair; game++ ) {
+            if( game % 2 == 0 ) { result.push_back( Pairing{ a, opponent } ); }
+            else { result.push_back( Pairing{ opponent, a } ); }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "defines.hpp"
+#include "policy.hpp"
+#include <vector>
+
+// Self-play tournaments between paddle policies, played on headless Pongs,
+// with Elo and Glicko ratings of the entrants.
+
+const f64 RATING_INITIAL    = 1500.0;
+const f64 ELO_K             = 16.0;
+const f64 GLICKO_INITIAL_RD = 350.0;
+
+struct GameSettings {
+    // first to this many points wins
+    u32 targetScore = 11;
+    // a game still going after this many ticks ends on its current score
+    u32 maxTicks = 120 * 60 * 5;
+    DeltaTime tickLength = 1.0f / 120.0f;
+    u64 seed = DEFAULT_RNG_SEED;
+};
+
+// entrant indices, left plays the player's paddle
+struct Pairing {
+    u32 left;
+    u32 right;
+};
+
+struct GameResult {
+    u32 id;
+    u32 left;
+    u32 right;
+    u32 leftScore;
+    u32 rightScore;
+    u32 ticks;
+};
+
+// id picks the match's rng streams, the same id always plays out the same way
+GameResult PlayGame( const Policy& left, const Policy& right, const GameSettings& settings, u32 id );
+// 1 for a left win, 0.5 for a draw and 0 for a loss
+f64 LeftGameScore( const GameResult& game );
+
+struct Rating {
+    f64 elo;
+    f64 glicko;
+    f64 rd;
+    u32 wins;
+    u32 losses;
+    u32 draws;
+};
+
+Rating InitialRating();
+// wins plus half the draws, what swiss pairings sort by
+f64 TournamentPoints( const Rating& rating );
+void UpdateElo( std::vector<Rating>& ratings, const GameResult& game );
+// One Glicko rating period, every game in it counts as played at the same time.
+// Also counts the wins, losses and draws.
+void UpdateGlicko( std::vector<Rating>& ratings, const GameResult* games, u32 count );
+// 95% confidence interval of the Glicko rating
+void GlickoInterval( const Rating& rating, f64& low, f64& high );
+
+// every entrant against every other gamesPerPair times, alternating sides
+std::vector<Pairing> RoundRobinPairings( u32 entrants, u32 gamesPerPair );
+// One swiss round: entrants sorted by points then rating are paired with the next
+// one down they haven't met yet, met is entrants * entrants and is updated.
+// With an odd number of entrants the last one sits the round out.
+std::vector<Pairing> SwissPairings( const std::vector<Rating>& ratings, std::vector<u8>& met, u32 gamesPerPair );
@@ -0,0 +1,74 @@
+#include "vecenv.hpp"
+
+VecEnv::VecEnv( const VecEnvConfig& config ) {
+    m_config = config;
+    if( m_config.frameSkip == 0 ) { m_config.frameSkip = 1; }
+    m_batch = CreateBatch( m_config.envCount, m_config.seed );
+    m_batch.rules = m_config.rules;
+    // padding lanes are stepped too so the kernel only sees whole registers
+    m_inputs.resize( m_batch.capacity );
+    m_episodeSteps.resize( m_config.envCount );
+}
+
+VecEnv::~VecEnv() {
+    FreeBatch( m_batch );
+}
+
+void VecEnv::ResetEnv( u32 env ) {
+    ResetLane( m_batch, env, MatchRngKey(m_config.seed, m_nextMatch++) );
+    // a new Pong waits a whole round before serving, nothing to learn from that
+    m_batch.scoreTimer[env] = m_batch.rules.delayBetweenRounds;
+    m_episodeSteps[env] = 0;
+}
+
+void VecEnv::Observe( f32* observations ) const {
+    for( u32 env = 0; env < m_config.envCount; env++ ) {
+        f32* row = observations + env * VEC_ENV_OBSERVATION_SIZE;
+        row[0] = m_batch.ballX[env];
+        row[1] = m_batch.ballY[env];
+        row[2] = m_batch.dirX[env];
+        row[3] = m_batch.dirY[env];
+        row[4] = m_batch.playerY[env];
+        row[5] = m_batch.cpuY[env];
+        row[6] = m_batch.scored[env] ? 1.0f : 0.0f;
+    }
+}
+
+void VecEnv::Reset( f32* observations ) {
+    m_nextMatch = 0;
+    for( u32 env = 0; env < m_config.envCount; env++ ) {
+        ResetEnv( env );
+    }
+    Observe( observations );
+}
+
+void VecEnv::Step( const u8* actions, f32* observations, f32* rewards, u8* dones ) {
+    u32 envCount = m_config.envCount;
+    for( u32 env = 0; env < envCount; env++ ) {
+        m_inputs[env].up   = actions[env] == ENV_ACTION_UP;
+        m_inputs[env].down = actions[env] == ENV_ACTION_DOWN;
+        // the score difference before the step, the reward is how much it changes
+        rewards[env] = (f32)m_batch.cpuScore[env] - (f32)m_batch.playerScore[env];
+    }
+
+    for( u32 frame = 0; frame < m_config.frameSkip; frame++ ) {
+        StepBatch( m_batch, 0, m_batch.capacity, m_config.tickLength, m_inputs.data() );
+    }
+
+    for( u32 env = 0; env < envCount; env++ ) {
+        u32 playerScore = m_batch.playerScore[env];
+        u32 cpuScore    = m_batch.cpuScore[env];
+        rewards[env] += (f32)playerScore - (f32)cpuScore;
+
+        m_episodeSteps[env]++;
+        bool done = playerScore >= m_config.pointsToWin || cpuScore >= m_config.pointsToWin ||
+            (m_config.maxEpisodeSteps && m_episodeSteps[env] >= m_config.maxEpisodeSteps);
+        dones[env] = done;
+        if( done ) {
+            ResetEnv( env );
+            m_episodes++;
+        }
+    }
+
+    Observe( observations );
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "defines.hpp"
+#include "batch.hpp"
+#include <vector>
+
+// Gym style vectorized environment for training agents.
+// envCount matches are stepped together with the batch simulator, the agent
+// plays the left paddle against CpuDY. Every buffer passed in is owned by the
+// caller and written in place, nothing is allocated after construction.
+
+// ball x, ball y, ball direction x, y, player y, cpu y, 1 while waiting for a serve
+const u32 VEC_ENV_OBSERVATION_SIZE = 7;
+
+enum EnvAction : u8 {
+    ENV_ACTION_STAY = 0,
+    ENV_ACTION_UP,
+    ENV_ACTION_DOWN,
+    ENV_ACTION_COUNT
+};
+
+struct VecEnvConfig {
+    u32 envCount = 64;
+    // ticks simulated per Step, the action is held for all of them
+    u32 frameSkip = 4;
+    DeltaTime tickLength = 1.0f / 120.0f;
+    // an episode ends when either side has this many points
+    u32 pointsToWin = 21;
+    // or after this many Steps, 0 for no limit
+    u32 maxEpisodeSteps = 0;
+    u64 seed = DEFAULT_RNG_SEED;
+    // cpuAimX and cpuSpeed set how hard the cpu is to beat
+    GameRules rules = DEFAULT_RULES;
+};
+
+class VecEnv {
+public:
+    explicit VecEnv( const VecEnvConfig& config );
+    ~VecEnv();
+    VecEnv( const VecEnv& ) = delete;
+    VecEnv& operator=( const VecEnv& ) = delete;
+
+    // starts a new episode in every env.
+    // observations holds envCount rows of VEC_ENV_OBSERVATION_SIZE
+    void Reset( f32* observations );
+    // Holds actions[envCount] for frameSkip ticks. rewards gets points won minus
+    // points lost during the step, dones is 1 where an episode ended. Finished envs
+    // are reset right away, so their observation is the first of the next episode.
+    void Step( const u8* actions, f32* observations, f32* rewards, u8* dones );
+
+    u32 EnvCount() const { return m_config.envCount; }
+    // episodes finished so far, over every env
+    u64 EpisodeCount() const { return m_episodes; }
+private:
+    void ResetEnv( u32 env );
+    void Observe( f32* observations ) const;
+
+    VecEnvConfig m_config;
+    BatchState m_batch;
+    std::vector<PlayerInput> m_inputs;
+    std::vector<u32> m_episodeSteps;
+    // every episode is a new match id so none of them replay the same bounces
+    u32 m_nextMatch = 0;
+    u64 m_episodes  = 0;
+};
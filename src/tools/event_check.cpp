@@ -0,0 +1,103 @@
+// Plays the same AI vs AI matches with the tick simulator, stepping StepBatch every
+// 1/120 s, and with the event driven simulator in swept steps of -dt seconds, the
+// whole match in one step by default. Then reports how closely they agree and how
+// much work each needed. The step length shouldn't change the match.
+// usage: event_check [-m matches] [-s seconds] [-dt seconds] [-tol distance]
+#include "./sim/batch.hpp"
+#include "./sim/analytic.hpp"
+#include "./sim/statehash.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const u64 CHECK_SEED = 99;
+
+int main( int argc, char** argv ) {
+    u32 matches   = 2000;
+    f32 seconds   = 60.0f;
+    f32 tolerance = 0.02f;
+    f64 stepLength = 0.0;
+    for( int i = 1; i + 1 < argc; i += 2 ) {
+        if( strcmp(argv[i], "-m") == 0 )        { matches    = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-s") == 0 )   { seconds    = (f32)atof(argv[i + 1]); }
+        else if( strcmp(argv[i], "-dt") == 0 )  { stepLength = atof(argv[i + 1]); }
+        else if( strcmp(argv[i], "-tol") == 0 ) { tolerance  = (f32)atof(argv[i + 1]); }
+    }
+    const DeltaTime ts = SWEPT_TICK_LENGTH;
+    u32 ticks = (u32)llround( seconds / ts );
+    f64 duration = (f64)ticks * ts;
+    if( stepLength <= 0.0 ) { stepLength = duration; }
+    u32 steps = (u32)ceil( duration / stepLength );
+
+    BatchState ticked = CreateBatch( matches, CHECK_SEED );
+    BatchState simd   = CreateBatch( matches, CHECK_SEED );
+    BatchState events = CreateBatch( matches, CHECK_SEED );
+    ScatterBatch( ticked, CHECK_SEED );
+    ScatterBatch( simd, CHECK_SEED );
+    ScatterBatch( events, CHECK_SEED );
+
+    SimdLevel level = DetectSimdLevel();
+    auto start = std::chrono::steady_clock::now();
+    for( u32 tick = 0; tick < ticks; tick++ ) {
+        StepBatchLevel( ticked, 0, matches, ts, nullptr, SIMD_SCALAR );
+    }
+    auto scalarEnd = std::chrono::steady_clock::now();
+    for( u32 tick = 0; tick < ticks; tick++ ) {
+        StepBatchLevel( simd, 0, matches, ts, nullptr, level );
+    }
+    auto simdEnd = std::chrono::steady_clock::now();
+    u64 eventCount = 0;
+    for( u32 step = 0; step < steps; step++ ) {
+        // the last step stops where the ticking did
+        f64 time = step * stepLength;
+        DeltaTime length = (DeltaTime)fmin( stepLength, duration - time );
+        for( u32 lane = 0; lane < matches; lane++ ) {
+            eventCount += AdvanceMatchAnalytic( LaneRef(events, lane), time, length, ts ).events;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    u32 agree     = 0;
+    u32 identical = 0;
+    f64 error     = 0.0;
+    u64 tickedPoints = 0;
+    u64 eventPoints  = 0;
+    for( u32 lane = 0; lane < matches; lane++ ) {
+        GameState a = LoadGameState( ticked, lane );
+        GameState b = LoadGameState( events, lane );
+        f32 ballError   = a.scored ? 0.0f : fmaxf( fabsf(a.ball.x - b.ball.x), fabsf(a.ball.y - b.ball.y) );
+        f32 paddleError = fmaxf( fabsf(a.player.y - b.player.y), fabsf(a.cpu.y - b.cpu.y) );
+        f32 laneError   = fmaxf( ballError, paddleError );
+        bool same = a.playerScore == b.playerScore && a.cpuScore == b.cpuScore &&
+                    a.scored == b.scored && laneError <= tolerance;
+        if( same ) {
+            agree++;
+            error += laneError;
+        }
+        if( HashPongState(a, ticked.scoreTimer[lane], ticked.tick[lane]) ==
+            HashPongState(b, events.scoreTimer[lane], events.tick[lane]) ) { identical++; }
+        tickedPoints += a.playerScore + a.cpuScore;
+        eventPoints  += b.playerScore + b.cpuScore;
+    }
+
+    f64 scalarSeconds = std::chrono::duration<f64>( scalarEnd - start ).count();
+    f64 simdSeconds   = std::chrono::duration<f64>( simdEnd - scalarEnd ).count();
+    f64 eventSeconds  = std::chrono::duration<f64>( end - simdEnd ).count();
+    printf("matches        %u, %.1f s each\n", matches, seconds);
+    printf("agreeing       %u (%.2f%%) within %.3f, mean error %.5f\n",
+        agree, 100.0 * agree / matches, tolerance, agree ? error / agree : 0.0);
+    printf("identical      %u (%.2f%%) down to the last bit\n", identical, 100.0 * identical / matches);
+    printf("points         %llu ticked, %llu event driven\n", (unsigned long long)tickedPoints, (unsigned long long)eventPoints);
+    printf("ticked         %u ticks/match, %.3f s scalar, %.3f s %s\n", ticks, scalarSeconds, simdSeconds, SimdLevelName(level));
+    printf("event driven   %u steps of %.4f s, %.1f stepped ticks/match, %.3f s\n",
+        steps, stepLength, (f64)eventCount / matches, eventSeconds);
+    printf("speedup        %.1fx over scalar, %.1fx over %s\n",
+        scalarSeconds / eventSeconds, simdSeconds / eventSeconds, SimdLevelName(level));
+
+    FreeBatch( events );
+    FreeBatch( simd );
+    FreeBatch( ticked );
+    return 0;
+}
@@ -0,0 +1,73 @@
+// Plays matches in Q16.16 fixed point (FixedPointRules), prints a hash of every
+// tick of every match and compares the speed with the float game. Builds with
+// different compilers or flags (-ffast-math, -ffp-contract=fast, -march=...)
+// have to print the same hash, -expect makes a mismatch an error.
+// usage: fixed_check [-m matches] [-n ticks] [-expect hash]
+#include "./sim/statehash.hpp"
+#include "./core/physics.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+const DeltaTime FIXED_CHECK_TS = 1.0f / 120.0f;
+
+// plays every match ticks ticks with the bot on the left,
+// returns the seconds it took and rolls every tick's state into hash if given
+template<typename Rules>
+f64 PlayMatches( u32 matches, u32 ticks, u64* hash, u32* points ) {
+    using Real = typename Rules::Real;
+    std::vector<BasicPong<Rules>> pongs;
+    for( u32 i = 0; i < matches; i++ ) { pongs.emplace_back( DEFAULT_RNG_SEED, i ); }
+
+    u64 rolling = STATE_HASH_SEED;
+    typename BasicPong<Rules>::Snapshot snapshot;
+    auto start = std::chrono::steady_clock::now();
+    for( u32 tick = 0; tick < ticks; tick++ ) {
+        for( BasicPong<Rules>& pong : pongs ) {
+            const BasicGameState<Real>& state = pong.GetGameState();
+            pong.UpdateGame( FIXED_CHECK_TS, BotInput(state.ball.x, state.ball.y, state.player.y, Rules::VALUES) );
+            if( hash ) {
+                pong.SaveSnapshot( snapshot );
+                rolling = RollHash( rolling, HashPongState(snapshot) );
+            }
+        }
+    }
+    f64 seconds = std::chrono::duration<f64>( std::chrono::steady_clock::now() - start ).count();
+
+    if( hash ) { *hash = rolling; }
+    *points = 0;
+    for( BasicPong<Rules>& pong : pongs ) {
+        *points += pong.GetGameState().playerScore + pong.GetGameState().cpuScore;
+    }
+    return seconds;
+}
+
+int main( int argc, char** argv ) {
+    u32 matches = 256;
+    u32 ticks   = 20000;
+    u64 expect  = 0;
+    for( int i = 1; i + 1 < argc; i += 2 ) {
+        if( strcmp(argv[i], "-m") == 0 )           { matches = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-n") == 0 )      { ticks   = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-expect") == 0 ) { expect  = strtoull(argv[i + 1], nullptr, 16); }
+    }
+
+    u64 hash = 0;
+    u32 fixedPoints = 0, floatPoints = 0;
+    PlayMatches<FixedPointRules>( matches, ticks, &hash, &fixedPoints );
+    f64 fixedSeconds = PlayMatches<FixedPointRules>( matches, ticks, nullptr, &fixedPoints );
+    f64 floatSeconds = PlayMatches<ClassicRules>( matches, ticks, nullptr, &floatPoints );
+
+    u64 total = (u64)matches * ticks;
+    printf("%u matches, %u ticks each\n", matches, ticks);
+    printf("  fixed   %8.2f Mticks/s  %u points\n", total / fixedSeconds / 1e6, fixedPoints);
+    printf("  float   %8.2f Mticks/s  %u points\n", total / floatSeconds / 1e6, floatPoints);
+    printf("hash      %016llx\n", (unsigned long long)hash);
+    if( expect && expect != hash ) {
+        printf("expected  %016llx\n", (unsigned long long)expect);
+        return 1;
+    }
+    return 0;
+}
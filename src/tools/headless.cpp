@@ -0,0 +1,95 @@
+// Runs many AI vs AI matches without a window and reports simulation throughput.
+// usage: headless [-m matches] [-t threads] [-n ticks] [-dt seconds] [-swept] [-trace out.json]
+#include "./sim/batch.hpp"
+#include "./sim/jobs.hpp"
+#include "./core/profile.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+struct HeadlessArgs {
+    u32 matches = 4096;
+    u32 threads = 0;
+    u32 ticks   = 10000;
+    f32 ts      = 1.0f / 60.0f;
+    bool swept  = false;
+    // chrome trace of the run, needs a build with PROFILE defined
+    const char* trace = nullptr;
+};
+
+bool ParseArgs( int argc, char** argv, HeadlessArgs& args ) {
+    for( int i = 1; i < argc; i++ ) {
+        if( strcmp(argv[i], "-swept") == 0 ) { args.swept = true; continue; }
+        if( i + 1 >= argc ) { return false; }
+        const char* value = argv[++i];
+        if( strcmp(argv[i - 1], "-m") == 0 )       { args.matches = (u32)atoi(value); }
+        else if( strcmp(argv[i - 1], "-t") == 0 )  { args.threads = (u32)atoi(value); }
+        else if( strcmp(argv[i - 1], "-n") == 0 )  { args.ticks   = (u32)atoi(value); }
+        else if( strcmp(argv[i - 1], "-dt") == 0 ) { args.ts      = (f32)atof(value); }
+        else if( strcmp(argv[i - 1], "-trace") == 0 ) { args.trace = value; }
+        else { return false; }
+    }
+    return args.matches > 0 && args.ts > 0.0f;
+}
+
+int main( int argc, char** argv ) {
+    HeadlessArgs args = {};
+    if( !ParseArgs(argc, argv, args) ) {
+        printf("usage: headless [-m matches] [-t threads] [-n ticks] [-dt seconds] [-swept] [-trace out.json]\n");
+        return -1;
+    }
+    if( args.threads == 0 ) { args.threads = CoreCount(); }
+
+    BatchState batch = CreateBatch( args.matches );
+    JobPool pool( args.threads - 1 );
+    // enough chunks for every thread to steal from, big enough to stay in SIMD
+    u32 grain = batch.capacity / (args.threads * 8);
+    if( grain == 0 ) { grain = BATCH_LANE_ALIGN; }
+
+    PROFILE_THREAD_NAME("Main");
+    auto start = std::chrono::steady_clock::now();
+
+    if( args.swept ) {
+        PROFILE_ZONE("StepBatchSwept");
+        ParallelFor( pool, batch.capacity, grain, [&batch, &args]( u32 first, u32 count ) {
+            for( u32 tick = 0; tick < args.ticks; tick++ ) {
+                StepBatchSwept( batch, first, count, tick * (f64)args.ts, args.ts, nullptr );
+            }
+        } );
+    } else {
+        PROFILE_ZONE("RunBatch");
+        RunBatch( pool, batch, args.ticks, args.ts, grain );
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    f64 seconds = std::chrono::duration<f64>( end - start ).count();
+    f64 ticks   = (f64)args.matches * (f64)args.ticks;
+
+    u64 playerPoints = 0;
+    u64 cpuPoints    = 0;
+    for( u32 lane = 0; lane < batch.count; lane++ ) {
+        playerPoints += batch.playerScore[lane];
+        cpuPoints    += batch.cpuScore[lane];
+    }
+
+    printf("matches       %u\n", args.matches);
+    printf("threads       %u\n", args.threads);
+    printf("collision     %s\n", args.swept ? "swept" : SimdLevelName(DetectSimdLevel()));
+    printf("ticks/match   %u (%.1f s of game time)\n", args.ticks, args.ticks * args.ts);
+    printf("elapsed       %.3f s\n", seconds);
+    printf("ticks/second  %.0f\n", ticks / seconds);
+    printf("points        player %llu, cpu %llu\n",
+        (unsigned long long)playerPoints, (unsigned long long)cpuPoints);
+
+    if( args.trace ) {
+#ifdef PROFILE
+        if( !WriteChromeTrace(args.trace) ) { printf("can't write %s\n", args.trace); }
+#else
+        printf("built without PROFILE, no trace written\n");
+#endif
+    }
+
+    FreeBatch( batch );
+    return 0;
+}
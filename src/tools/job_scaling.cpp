@@ -0,0 +1,92 @@
+// Plays matches of very different lengths with 1 to every core, once with the
+// work stealing pool and once with a static split of the matches between threads.
+// usage: job_scaling [-m matches] [-n max ticks]
+#include "./sim/batch.hpp"
+#include "./sim/jobs.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+const u64 SCALING_SEED = 7;
+const f32 SCALING_TS   = 1.0f / 60.0f;
+
+// plays a chunk until every match in it has had a point scored,
+// some take a few ticks, some rally until maxTicks
+void PlayChunk( BatchState& batch, u32 first, u32 count, u32 maxTicks ) {
+    for( u32 tick = 0; tick < maxTicks; tick++ ) {
+        StepBatch( batch, first, count, SCALING_TS, nullptr );
+        bool done = true;
+        for( u32 lane = first; lane < first + count && done; lane++ ) {
+            done = batch.playerScore[lane] + batch.cpuScore[lane] > 0;
+        }
+        if( done ) { return; }
+    }
+}
+
+f64 RunStatic( BatchState& batch, u32 threads, u32 maxTicks ) {
+    u32 chunks = batch.capacity / BATCH_LANE_ALIGN;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for( u32 thread = 0; thread < threads; thread++ ) {
+        u32 firstChunk = chunks * thread / threads;
+        u32 lastChunk  = chunks * (thread + 1) / threads;
+        workers.emplace_back( [&batch, firstChunk, lastChunk, maxTicks]() {
+            for( u32 chunk = firstChunk; chunk < lastChunk; chunk++ ) {
+                PlayChunk( batch, chunk * BATCH_LANE_ALIGN, BATCH_LANE_ALIGN, maxTicks );
+            }
+        } );
+    }
+    for( std::thread& worker : workers ) { worker.join(); }
+    return std::chrono::duration<f64>( std::chrono::steady_clock::now() - start ).count();
+}
+
+f64 RunPool( BatchState& batch, u32 threads, u32 maxTicks ) {
+    JobPool pool( threads - 1 );
+    auto start = std::chrono::steady_clock::now();
+    ParallelFor( pool, batch.capacity, BATCH_LANE_ALIGN, [&batch, maxTicks]( u32 first, u32 count ) {
+        PlayChunk( batch, first, count, maxTicks );
+    } );
+    return std::chrono::duration<f64>( std::chrono::steady_clock::now() - start ).count();
+}
+
+int main( int argc, char** argv ) {
+    u32 matches  = 16384;
+    u32 maxTicks = 20000;
+    for( int i = 1; i + 1 < argc; i += 2 ) {
+        if( strcmp(argv[i], "-m") == 0 )      { matches  = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-n") == 0 ) { maxTicks = (u32)atoi(argv[i + 1]); }
+    }
+
+    BatchState batch = CreateBatch( matches, SCALING_SEED );
+    u32 cores = CoreCount();
+    f64 staticBase = 0.0;
+    f64 poolBase   = 0.0;
+
+    printf("threads   static s  speedup      pool s  speedup  efficiency\n");
+    for( u32 threads = 1; threads <= cores; threads++ ) {
+        ResetBatch( batch, SCALING_SEED );
+        ScatterBatch( batch, SCALING_SEED );
+        f64 staticSeconds = RunStatic( batch, threads, maxTicks );
+
+        ResetBatch( batch, SCALING_SEED );
+        ScatterBatch( batch, SCALING_SEED );
+        f64 poolSeconds = RunPool( batch, threads, maxTicks );
+
+        if( threads == 1 ) {
+            staticBase = staticSeconds;
+            poolBase   = poolSeconds;
+        }
+        printf("%7u %10.3f %8.2fx %11.3f %8.2fx %10.0f%%\n",
+            threads,
+            staticSeconds, staticBase / staticSeconds,
+            poolSeconds, poolBase / poolSeconds,
+            100.0 * poolBase / (poolSeconds * threads)
+        );
+    }
+
+    FreeBatch( batch );
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Steps the multi ball stress scene at several ball counts on 1 to every core
+// and reports ticks per second, how well it scales and whether every thread
+// count ended in exactly the same state.
+// usage: multiball_bench [-b balls,balls,...] [-f fill] [-w ball ticks per run]
+#include "./sim/multiball.hpp"
+#include "./sim/jobs.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+const u64 MULTI_BALL_BENCH_SEED = 11;
+const DeltaTime MULTI_BALL_BENCH_TS = 1.0f / 120.0f;
+
+u64 HashBalls( const MultiBallState& state ) {
+    const MultiBallArrays& balls = state.balls[state.front];
+    u64 hash = 0xcbf29ce484222325ull;
+    for( u32 i = 0; i < state.count; i++ ) {
+        u32 bits[4];
+        memcpy( &bits[0], &balls.x[i],  4 );
+        memcpy( &bits[1], &balls.y[i],  4 );
+        memcpy( &bits[2], &balls.vx[i], 4 );
+        memcpy( &bits[3], &balls.vy[i], 4 );
+        for( u32 b : bits ) { hash = (hash ^ b) * 0x100000001b3ull; }
+    }
+    return hash ^ ((u64)state.playerScore << 32 | state.cpuScore);
+}
+
+int main( int argc, char** argv ) {
+    std::vector<u32> counts = { 1000, 10000, 100000, 1000000 };
+    f32 fill = 0.1f;
+    u64 work = 20000000;
+    for( int i = 1; i + 1 < argc; i += 2 ) {
+        if( strcmp(argv[i], "-b") == 0 ) {
+            counts.clear();
+            for( char* item = strtok(argv[i + 1], ","); item; item = strtok(nullptr, ",") ) {
+                counts.push_back( (u32)atoi(item) );
+            }
+        }
+        else if( strcmp(argv[i], "-f") == 0 ) { fill = (f32)atof(argv[i + 1]); }
+        else if( strcmp(argv[i], "-w") == 0 ) { work = strtoull(argv[i + 1], nullptr, 10); }
+    }
+
+    u32 cores = CoreCount();
+    printf("    balls  threads  ticks    ticks/s  M balls/s  speedup  contacts/tick  state\n");
+    for( u32 count : counts ) {
+        u32 ticks = (u32)std::max<u64>( work / std::max(count, 1u), 10 );
+        f32 size  = MultiBallSize( count, fill );
+        f64 base  = 0.0;
+        u64 baseHash = 0;
+        for( u32 threads = 1; threads <= cores; threads++ ) {
+            MultiBallState state = CreateMultiBall( count, size, MULTI_BALL_BENCH_SEED );
+            JobPool pool( threads - 1 );
+            u64 contacts = 0;
+            auto start = std::chrono::steady_clock::now();
+            for( u32 tick = 0; tick < ticks; tick++ ) {
+                StepMultiBall( pool, state, MULTI_BALL_BENCH_TS );
+                contacts += state.contacts;
+            }
+            f64 seconds = std::chrono::duration<f64>( std::chrono::steady_clock::now() - start ).count();
+            u64 hash = HashBalls( state );
+            if( threads == 1 ) {
+                base     = seconds;
+                baseHash = hash;
+            }
+            printf("%9u %8u %6u %10.1f %10.2f %7.2fx %14.1f  %s\n",
+                count, threads, ticks, ticks / seconds, (f64)count * ticks / seconds / 1e6,
+                base / seconds, (f64)contacts / ticks, hash == baseHash ? "same" : "DIFFERS");
+            FreeMultiBall( state );
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Records AI matches to replay files, then checks that seeking into every
+// replay gives the same state as playing it straight through.
+// usage: replay_record <directory> [-m matches] [-n ticks] [-k keyframe interval] [-h hash interval]
+#include "./sim/replay.hpp"
+#include "./sim/file.hpp"
+#include "./sim/policy.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+const u64 RECORD_SEED  = 2024;
+const f32 RECORD_TICK  = 1.0f / 120.0f;
+
+std::string ReplayPath( const char* directory, u32 match ) {
+    char name[64];
+    snprintf( name, sizeof(name), "match_%05u.pongreplay", match );
+    return (std::filesystem::path(directory) / name).string();
+}
+
+bool SameSnapshot( const PongSnapshot& a, const PongSnapshot& b ) {
+    return memcmp( &a.gameState.ball, &b.gameState.ball, sizeof(Ball) ) == 0 &&
+        a.gameState.player.y == b.gameState.player.y &&
+        a.gameState.cpu.y == b.gameState.cpu.y &&
+        a.gameState.playerScore == b.gameState.playerScore &&
+        a.gameState.cpuScore == b.gameState.cpuScore &&
+        a.gameState.scored == b.gameState.scored &&
+        a.scoreTimer == b.scoreTimer && a.tick == b.tick;
+}
+
+int main( int argc, char** argv ) {
+    if( argc < 2 ) {
+        printf("usage: replay_record <directory> [-m matches] [-n ticks] [-k keyframe interval] [-h hash interval]\n");
+        return -1;
+    }
+    const char* directory = argv[1];
+    u32 matches  = 16;
+    u32 ticks    = 120 * 60 * 5;
+    u32 interval = REPLAY_DEFAULT_KEYFRAME_INTERVAL;
+    u32 hashInterval = REPLAY_DEFAULT_HASH_INTERVAL;
+    for( int i = 2; i + 1 < argc; i += 2 ) {
+        if( strcmp(argv[i], "-m") == 0 )      { matches  = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-n") == 0 ) { ticks    = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-k") == 0 ) { interval = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-h") == 0 ) { hashInterval = (u32)atoi(argv[i + 1]); }
+    }
+    std::filesystem::create_directories( directory );
+
+    size_t totalBytes = 0;
+    u32 failures = 0;
+    for( u32 match = 0; match < matches; match++ ) {
+        Pong pong( RECORD_SEED, match );
+        PlayerInput start = {};
+        start.enter = true;
+        pong.UpdateMenu( start );
+
+        // every few hundred ticks is kept to check seeking against
+        std::vector<PongSnapshot> expected;
+        ReplayWriter writer( RECORD_TICK, interval, hashInterval );
+        u64 botKey = MatchRngKey( RECORD_SEED ^ 0xb07, match );
+        PlayerInput input = {};
+        for( u32 tick = 0; tick <= ticks; tick++ ) {
+            if( tick % 307 == 0 || tick == ticks ) {
+                PongSnapshot snapshot;
+                pong.SaveSnapshot(snapshot);
+                expected.push_back(snapshot);
+            }
+            if( tick == ticks ) {
+                writer.Finish( pong );
+                break;
+            }
+            // the sloppy policy's inputs change the way a person's do, not every tick
+            input = SloppyPolicy( PolicyView{ pong.GetGameState(), tick, botKey, input } );
+            writer.Record( pong, input );
+            pong.UpdateGame( RECORD_TICK, input );
+        }
+
+        std::vector<u8> bytes = writer.Serialize();
+        std::string path = ReplayPath( directory, match );
+        if( !WriteEntireFile(path.c_str(), bytes.data(), bytes.size()) ) {
+            printf("failed to write %s\n", path.c_str());
+            return -1;
+        }
+        totalBytes += bytes.size();
+
+        MappedFile file = MapFile( path.c_str() );
+        ReplayView view;
+        if( !OpenReplay(file.data, file.size, view) ) {
+            printf("failed to open %s\n", path.c_str());
+            failures++;
+            continue;
+        }
+        for( const PongSnapshot& snapshot : expected ) {
+            Pong seeked;
+            ReplayCursor cursor;
+            PongSnapshot result;
+            u32 replayTick = snapshot.tick - expected[0].tick;
+            if( !SeekReplay(view, replayTick, seeked, cursor) ) { failures++; continue; }
+            seeked.SaveSnapshot(result);
+            if( !SameSnapshot(snapshot, result) ) {
+                printf("%s: seek to tick %u differs\n", path.c_str(), replayTick);
+                failures++;
+            }
+        }
+        GameState final = pong.GetGameState();
+        printf("%s  %6zu bytes  %u runs  score %u - %u\n",
+            path.c_str(), bytes.size(), view.header->runCount, final.playerScore, final.cpuScore);
+        UnmapFile( file );
+    }
+
+    printf("%u replays, %u ticks each, %.1f KB average, %u seek failures\n",
+        matches, ticks, totalBytes / 1024.0 / matches, failures);
+    return failures == 0 ? 0 : -1;
+}
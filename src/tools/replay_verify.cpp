@@ -0,0 +1,147 @@
+// Plays back every replay in a directory as fast as it can, hashing the state
+// every tick, and reports the window of ticks in which a replay stopped
+// matching its recorded hashes. Replays are verified in parallel, one job per file.
+// usage: replay_verify <directory> [-t threads]
+#include "./sim/replay.hpp"
+#include "./sim/statehash.hpp"
+#include "./sim/file.hpp"
+#include "./sim/jobs.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+const u32 NO_DIVERGENCE = ~0u;
+
+struct VerifyResult {
+    bool opened;
+    u32  ticks;
+    // checkpoint whose state doesn't match the recording, or NO_DIVERGENCE.
+    // Hashes are only stored every hashInterval ticks, so the state first went
+    // wrong somewhere from windowStart, the tick after the last matching
+    // checkpoint, up to firstBad.
+    u32  firstBad;
+    u32  windowStart;
+};
+
+bool SameKeyframe( const ReplayKeyframe& a, const ReplayKeyframe& b ) {
+    // tick, run and runOffset locate the keyframe, they aren't game state
+    return memcmp( &a.flags, &b.flags, sizeof(ReplayKeyframe) - offsetof(ReplayKeyframe, flags) ) == 0;
+}
+
+VerifyResult VerifyReplay( const ReplayView& view ) {
+    const ReplayHeader& header = *view.header;
+    VerifyResult result = {};
+    result.opened      = true;
+    result.ticks       = header.tickCount;
+    result.firstBad    = NO_DIVERGENCE;
+    result.windowStart = 0;
+    if( header.keyframeCount == 0 ) { return result; }
+
+    Pong pong;
+    pong.RestoreSnapshot( KeyframeSnapshot(view.keyframes[0]) );
+    ReplayCursor cursor = KeyframeCursor( view.keyframes[0] );
+    u64 rolling  = STATE_HASH_SEED;
+    u32 keyframe = 0;
+    PongSnapshot snapshot;
+    for( u32 tick = 0; tick < header.tickCount; tick++ ) {
+        pong.SaveSnapshot(snapshot);
+        rolling = RollHash( rolling, HashPongState(snapshot) );
+
+        bool checked = false;
+        if( tick % header.hashInterval == 0 ) {
+            u32 index = tick / header.hashInterval;
+            if( index < header.hashCount && view.hashes[index] != rolling ) {
+                result.firstBad = tick;
+                return result;
+            }
+            checked = true;
+        }
+        // keyframes hold the full state, so they're checked too
+        if( keyframe < header.keyframeCount && view.keyframes[keyframe].tick == tick ) {
+            ReplayKeyframe played = MakeKeyframe(snapshot);
+            if( !SameKeyframe(played, view.keyframes[keyframe]) ) {
+                result.firstBad = tick;
+                return result;
+            }
+            checked = true;
+            keyframe++;
+        }
+        if( checked ) { result.windowStart = tick + 1; }
+
+        PlayerInput input = NextInput( view, cursor );
+        pong.UpdateGame( header.tickLength, input );
+    }
+
+    pong.SaveSnapshot(snapshot);
+    if( header.finalHash && RollHash(rolling, HashPongState(snapshot)) != header.finalHash ) {
+        result.firstBad = header.tickCount;
+    }
+    return result;
+}
+
+int main( int argc, char** argv ) {
+    if( argc < 2 ) {
+        printf("usage: replay_verify <directory> [-t threads]\n");
+        return -1;
+    }
+    const char* directory = argv[1];
+    u32 threads = std::max( std::thread::hardware_concurrency(), 1u );
+    for( int i = 2; i + 1 < argc; i += 2 ) {
+        if( strcmp(argv[i], "-t") == 0 ) { threads = std::max( atoi(argv[i + 1]), 1 ); }
+    }
+
+    std::vector<std::string> paths;
+    for( const auto& entry : std::filesystem::directory_iterator(directory) ) {
+        if( entry.is_regular_file() && entry.path().extension() == ".pongreplay" ) {
+            paths.push_back( entry.path().string() );
+        }
+    }
+    std::sort( paths.begin(), paths.end() );
+    if( paths.empty() ) {
+        printf("no .pongreplay files in %s\n", directory);
+        return -1;
+    }
+
+    std::vector<VerifyResult> results( paths.size() );
+    JobPool pool( threads - 1 );
+    auto start = std::chrono::steady_clock::now();
+    ParallelFor( pool, (u32)paths.size(), 1, [&paths, &results]( u32 first, u32 count ) {
+        for( u32 i = first; i < first + count; i++ ) {
+            MappedFile file = MapFile( paths[i].c_str() );
+            ReplayView view;
+            if( file.data && OpenReplay(file.data, file.size, view) ) {
+                results[i] = VerifyReplay( view );
+            } else {
+                results[i] = VerifyResult{};
+            }
+            UnmapFile( file );
+        }
+    } );
+    f64 seconds = std::chrono::duration<f64>( std::chrono::steady_clock::now() - start ).count();
+
+    u64 totalTicks = 0;
+    u32 failures   = 0;
+    for( size_t i = 0; i < paths.size(); i++ ) {
+        const VerifyResult& result = results[i];
+        totalTicks += result.ticks;
+        if( !result.opened ) {
+            printf("%s: not a valid replay\n", paths[i].c_str());
+            failures++;
+        } else if( result.firstBad != NO_DIVERGENCE ) {
+            printf("%s: diverges between ticks %u and %u\n",
+                paths[i].c_str(), result.windowStart, result.firstBad);
+            failures++;
+        }
+    }
+    printf("%zu replays, %u diverged, %llu ticks in %.3fs on %u threads, %.1f million ticks/s\n",
+        paths.size(), failures, (unsigned long long)totalTicks, seconds, threads,
+        totalTicks / seconds / 1e6);
+    return failures == 0 ? 0 : -1;
+}
@@ -0,0 +1,90 @@
+// Steps the same matches with each rule set built into BasicPong and reports
+// ticks per second, comparing rules folded in at compile time against the
+// same rules read from memory every tick (TunableRules).
+// usage: rules_bench [-m matches] [-n ticks]
+#include "./core/physics.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+const u32 RULES_BENCH_RUNS = 5;
+
+struct RulesTiming {
+    f64 seconds;
+    u64 points;
+    u64 hash;
+};
+
+template<typename Rules>
+RulesTiming TimeRulesOnce( u32 matches, u32 ticks ) {
+    using Real = typename Rules::Real;
+    const DeltaTime ts = 1.0f / 120.0f;
+    std::vector<BasicPong<Rules>> pongs;
+    for( u32 i = 0; i < matches; i++ ) { pongs.emplace_back( DEFAULT_RNG_SEED, i ); }
+
+    auto start = std::chrono::steady_clock::now();
+    for( u32 tick = 0; tick < ticks; tick++ ) {
+        for( BasicPong<Rules>& pong : pongs ) {
+            const BasicGameState<Real>& state = pong.GetGameState();
+            PlayerInput input = BotInput( state.ball.x, state.ball.y, state.player.y, Rules::VALUES );
+            pong.UpdateGame( ts, input );
+        }
+    }
+    RulesTiming result = {};
+    result.seconds = std::chrono::duration<f64>( std::chrono::steady_clock::now() - start ).count();
+
+    // folds the final states together so runs with the same rules can be compared
+    for( BasicPong<Rules>& pong : pongs ) {
+        const BasicGameState<Real>& state = pong.GetGameState();
+        result.points += state.playerScore + state.cpuScore;
+        f32 ballX = (f32)state.ball.x;
+        u32 bits;
+        memcpy( &bits, &ballX, sizeof(bits) );
+        result.hash = (result.hash ^ bits ^ state.cpuScore) * 0x100000001b3ull;
+    }
+    return result;
+}
+
+// keeps the fastest of the runs, the differences are small next to timer noise
+template<typename Rules>
+void TimeRules( RulesTiming& best, u32 run, u32 matches, u32 ticks ) {
+    RulesTiming timing = TimeRulesOnce<Rules>( matches, ticks );
+    if( run == 0 || timing.seconds < best.seconds ) { best = timing; }
+}
+
+void PrintTiming( const char* name, const RulesTiming& timing, u64 ticks, f64 baseline ) {
+    printf("  %-10s %8.2f Mticks/s %6.2fx  %llu points\n", name,
+        ticks / timing.seconds / 1e6, baseline / timing.seconds,
+        (unsigned long long)timing.points);
+}
+
+int main( int argc, char** argv ) {
+    u32 matches = 1024;
+    u32 ticks   = 10000;
+    for( int i = 1; i + 1 < argc; i += 2 ) {
+        if( strcmp(argv[i], "-m") == 0 )      { matches = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-n") == 0 ) { ticks   = (u32)atoi(argv[i + 1]); }
+    }
+
+    // same values as ClassicRules, only where they're read from differs
+    TunableRules::VALUES = ClassicRules::VALUES;
+    // runs take turns so clock and cache drift over time don't favour one rule set
+    RulesTiming tunable = {}, classic = {}, fast = {}, precise = {};
+    for( u32 run = 0; run < RULES_BENCH_RUNS; run++ ) {
+        TimeRules<TunableRules>( tunable, run, matches, ticks );
+        TimeRules<ClassicRules>( classic, run, matches, ticks );
+        TimeRules<FastRules>( fast, run, matches, ticks );
+        TimeRules<PreciseRules>( precise, run, matches, ticks );
+    }
+
+    u64 total = (u64)matches * ticks;
+    printf("%u matches, %u ticks each, relative to tunable\n", matches, ticks);
+    PrintTiming( "tunable", tunable, total, tunable.seconds );
+    PrintTiming( "classic", classic, total, tunable.seconds );
+    PrintTiming( "fast",    fast,    total, tunable.seconds );
+    PrintTiming( "precise", precise, total, tunable.seconds );
+    printf("classic and tunable %s\n", classic.hash == tunable.hash ? "match" : "DIFFER");
+    return classic.hash == tunable.hash ? 0 : 1;
+}
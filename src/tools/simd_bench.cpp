@@ -0,0 +1,89 @@
+// Steps the same batch with every instruction set this cpu supports,
+// checks the results against the scalar path lane for lane and reports the speedup.
+// usage: simd_bench [-m matches] [-n ticks]
+#include "./sim/batch.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+const u32 BENCH_SEED = 1234;
+
+// inputs that change every few ticks, exercises the explicit input path
+void FillInputs( std::vector<PlayerInput>& inputs, u32 tick ) {
+    for( u32 lane = 0; lane < inputs.size(); lane++ ) {
+        u32 phase = ((lane * 7 + tick) / 13) % 3;
+        inputs[lane].up   = phase == 0;
+        inputs[lane].down = phase == 1;
+    }
+}
+
+f64 RunBatch( BatchState& batch, SimdLevel level, u32 ticks, bool useInputs ) {
+    ResetBatch( batch, BENCH_SEED );
+    ScatterBatch( batch, BENCH_SEED );
+    std::vector<PlayerInput> inputs( batch.capacity );
+
+    auto start = std::chrono::steady_clock::now();
+    for( u32 tick = 0; tick < ticks; tick++ ) {
+        if( useInputs ) { FillInputs( inputs, tick ); }
+        StepBatchLevel( batch, 0, batch.count, 1.0f / 60.0f, useInputs ? inputs.data() : nullptr, level );
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<f64>( end - start ).count();
+}
+
+bool SameBatch( const BatchState& a, const BatchState& b ) {
+    for( u32 lane = 0; lane < a.count; lane++ ) {
+        GameState sa = LoadGameState( a, lane );
+        GameState sb = LoadGameState( b, lane );
+        if( memcmp(&sa.ball.x, &sb.ball.x, sizeof(f32)) != 0 ||
+            memcmp(&sa.ball.y, &sb.ball.y, sizeof(f32)) != 0 ||
+            memcmp(&sa.ball.direction, &sb.ball.direction, sizeof(sa.ball.direction)) != 0 ||
+            memcmp(&sa.player.y, &sb.player.y, sizeof(f32)) != 0 ||
+            memcmp(&sa.cpu.y, &sb.cpu.y, sizeof(f32)) != 0 ||
+            memcmp(&a.scoreTimer[lane], &b.scoreTimer[lane], sizeof(f32)) != 0 ||
+            sa.playerScore != sb.playerScore || sa.cpuScore != sb.cpuScore ||
+            sa.scored != sb.scored || a.tick[lane] != b.tick[lane]
+        ) {
+            printf("lane %u differs\n", lane);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main( int argc, char** argv ) {
+    u32 matches = 4099;
+    u32 ticks   = 2000;
+    for( int i = 1; i + 1 < argc; i += 2 ) {
+        if( strcmp(argv[i], "-m") == 0 )      { matches = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-n") == 0 ) { ticks   = (u32)atoi(argv[i + 1]); }
+    }
+
+    SimdLevel best = DetectSimdLevel();
+    BatchState reference = CreateBatch( matches );
+    BatchState batch     = CreateBatch( matches );
+
+    bool passed = true;
+    for( i32 inputMode = 0; inputMode < 2; inputMode++ ) {
+        bool useInputs = inputMode == 1;
+        printf("%s\n", useInputs ? "explicit inputs" : "bot inputs");
+        f64 scalarSeconds = RunBatch( reference, SimdLevel::SIMD_SCALAR, ticks, useInputs );
+        for( i32 level = SimdLevel::SIMD_SCALAR; level <= best; level++ ) {
+            f64 seconds = RunBatch( batch, (SimdLevel)level, ticks, useInputs );
+            bool same   = SameBatch( reference, batch );
+            passed = passed && same;
+            printf("  %-8s %8.2f Mticks/s  %5.2fx  %s\n",
+                SimdLevelName((SimdLevel)level),
+                (f64)matches * ticks / seconds / 1e6,
+                scalarSeconds / seconds,
+                same ? "match" : "MISMATCH"
+            );
+        }
+    }
+
+    FreeBatch( batch );
+    FreeBatch( reference );
+    return passed ? 0 : -1;
+}
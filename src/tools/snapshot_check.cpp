@@ -0,0 +1,124 @@
+// Plays matches with a snapshot ring recording every tick, rewinds each one, plays
+// the same inputs again and checks every tick hashes the same as the first time.
+// Then times saving and restoring a snapshot.
+// usage: snapshot_check [-m matches] [-n ticks] [-r rewind ticks]
+#include "./core/snapshot.hpp"
+#include "./sim/statehash.hpp"
+#include "./sim/policy.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+const u64 SNAPSHOT_CHECK_SEED = 77;
+const DeltaTime SNAPSHOT_CHECK_TS = 1.0f / 120.0f;
+const u32 SNAPSHOT_CHECK_RING = 256;
+// saves and restores timed, in a loop on their own
+const u32 SNAPSHOT_TIMED_COPIES = 10000000;
+
+using CheckRing = PongSnapshotRing<SNAPSHOT_CHECK_RING>;
+
+u64 HashPong( const Pong& pong ) {
+    PongSnapshot snapshot;
+    pong.SaveSnapshot( snapshot );
+    return HashPongState( snapshot );
+}
+
+// plays one match, rewinds it and replays it, returns false at the first thing that doesn't match
+bool CheckMatch( CheckRing& ring, u32 match, u32 ticks, u32 rewind ) {
+    Pong pong( SNAPSHOT_CHECK_SEED, match );
+    PlayerInput start = {};
+    start.enter = true;
+    pong.UpdateMenu( start );
+    ring.Clear();
+
+    // the sloppy policy's inputs change the way a person's do, not every tick
+    std::vector<PlayerInput> inputs( ticks );
+    std::vector<u64> hashes( ticks + 1 );
+    u64 botKey = MatchRngKey( SNAPSHOT_CHECK_SEED ^ 0xb07, match );
+    PlayerInput input = {};
+    for( u32 tick = 0; tick < ticks; tick++ ) {
+        ring.Record( pong );
+        hashes[tick] = HashPongState( *ring.Get(pong.CurrentTick()) );
+        input = SloppyPolicy( PolicyView{ pong.GetGameState(), tick, botKey, input } );
+        inputs[tick] = input;
+        pong.UpdateGame( SNAPSHOT_CHECK_TS, input );
+    }
+    ring.Record( pong );
+    hashes[ticks] = HashPong( pong );
+
+    u32 end = pong.CurrentTick();
+    u32 kept = ring.Count();
+    if( !ring.Rewind(pong, rewind) ) {
+        printf("match %u: couldn't rewind %u ticks from tick %u\n", match, rewind, end);
+        return false;
+    }
+    // the abandoned ticks are gone
+    if( pong.CurrentTick() != end - rewind || ring.Has(end - rewind + 1) || ring.Count() != kept - rewind ) {
+        printf("match %u: rewound to tick %u keeping %u snapshots\n", match, pong.CurrentTick(), ring.Count());
+        return false;
+    }
+
+    for( u32 tick = end - rewind; tick < end; tick++ ) {
+        if( HashPong(pong) != hashes[tick] ) {
+            printf("match %u: replay differs at tick %u\n", match, tick);
+            return false;
+        }
+        ring.Record( pong );
+        pong.UpdateGame( SNAPSHOT_CHECK_TS, inputs[tick] );
+    }
+    ring.Record( pong );
+    if( HashPong(pong) != hashes[end] ) {
+        printf("match %u: replay differs at tick %u\n", match, end);
+        return false;
+    }
+    // only the last ticks are kept
+    if( end >= SNAPSHOT_CHECK_RING && ring.Restore(pong, end - SNAPSHOT_CHECK_RING) ) {
+        printf("match %u: restored tick %u, older than the ring\n", match, end - SNAPSHOT_CHECK_RING);
+        return false;
+    }
+    return true;
+}
+
+int main( int argc, char** argv ) {
+    u32 matches = 16;
+    u32 ticks   = 120 * 60;
+    u32 rewind  = 100;
+    for( int i = 1; i + 1 < argc; i += 2 ) {
+        if( strcmp(argv[i], "-m") == 0 )      { matches = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-n") == 0 ) { ticks   = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-r") == 0 ) { rewind  = (u32)atoi(argv[i + 1]); }
+    }
+    if( rewind >= SNAPSHOT_CHECK_RING || rewind > ticks ) {
+        printf("can rewind at most %u ticks and no further than -n\n", SNAPSHOT_CHECK_RING - 1);
+        return -1;
+    }
+
+    static CheckRing ring;
+    u32 replayed = 0;
+    for( u32 match = 0; match < matches; match++ ) {
+        if( CheckMatch(ring, match, ticks, rewind) ) { replayed++; }
+    }
+
+    // the ring is left holding the last match's final ticks
+    Pong pong( SNAPSHOT_CHECK_SEED, 0 );
+    ring.Restore( pong, ring.Newest() );
+    auto start = std::chrono::steady_clock::now();
+    for( u32 i = 0; i < SNAPSHOT_TIMED_COPIES; i++ ) {
+        ring.Record( pong );
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for( u32 i = 0; i < SNAPSHOT_TIMED_COPIES; i++ ) {
+        ring.Restore( pong, pong.CurrentTick() );
+    }
+    auto end = std::chrono::steady_clock::now();
+    f64 saveNs    = std::chrono::duration<f64, std::nano>( middle - start ).count() / SNAPSHOT_TIMED_COPIES;
+    f64 restoreNs = std::chrono::duration<f64, std::nano>( end - middle ).count() / SNAPSHOT_TIMED_COPIES;
+
+    printf("matches        %u, %u ticks each, ring of %u ticks\n", matches, ticks, SNAPSHOT_CHECK_RING);
+    printf("rewound        %u ticks, %u of %u replayed identically\n", rewind, replayed, matches);
+    printf("save           %.1f ns\n", saveNs);
+    printf("restore        %.1f ns\n", restoreNs);
+    return replayed == matches ? 0 : 1;
+}
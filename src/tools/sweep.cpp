@@ -0,0 +1,137 @@
+// Plays thousands of matches between two paddle policies for every point of a
+// grid or random sample of game rules on every core, and writes balance metrics per point.
+// usage: sweep [-p name=low:high:steps]... [-l left policy] [-r right policy]
+//              [-samples count] [-m matches per point] [-n ticks] [-seed seed]
+//              [-t threads] [-csv out.csv] [-json out.json]
+// names: ballSpeed paddleSpeed bounceMax delay ballSize paddleH cpuAimX
+#include "./sim/sweep.hpp"
+#include "./sim/jobs.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+const u32 SWEEP_CHUNK_LANES = 512;
+const DeltaTime SWEEP_TICK_LENGTH = 1.0f / 120.0f;
+
+int main( int argc, char** argv ) {
+    std::vector<SweepAxis> axes;
+    u32 samples = 0;
+    u32 matches = 4096;
+    u32 ticks   = 120 * 60;
+    u64 seed    = DEFAULT_RNG_SEED;
+    u32 threads = 1;
+    const char* csvPath  = "sweep.csv";
+    const char* jsonPath = nullptr;
+    const char* leftName  = "sloppy";
+    const char* rightName = "cpu";
+    for( int i = 1; i + 1 < argc; i += 2 ) {
+        if( strcmp(argv[i], "-p") == 0 ) {
+            SweepAxis axis;
+            if( !ParseSweepAxis( argv[i + 1], axis ) ) {
+                printf("bad parameter %s, expected name=low:high:steps\n", argv[i + 1]);
+                return -1;
+            }
+            axes.push_back( axis );
+        }
+        else if( strcmp(argv[i], "-l") == 0 )       { leftName  = argv[i + 1]; }
+        else if( strcmp(argv[i], "-r") == 0 )       { rightName = argv[i + 1]; }
+        else if( strcmp(argv[i], "-samples") == 0 ) { samples = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-m") == 0 )       { matches = std::max( atoi(argv[i + 1]), 1 ); }
+        else if( strcmp(argv[i], "-n") == 0 )       { ticks   = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-seed") == 0 )    { seed    = strtoull(argv[i + 1], nullptr, 10); }
+        else if( strcmp(argv[i], "-t") == 0 )       { threads = std::max( atoi(argv[i + 1]), 1 ); }
+        else if( strcmp(argv[i], "-csv") == 0 )     { csvPath  = argv[i + 1]; }
+        else if( strcmp(argv[i], "-json") == 0 )    { jsonPath = argv[i + 1]; }
+    }
+
+    const Policy* left  = FindPolicy( leftName );
+    const Policy* right = FindPolicy( rightName );
+    if( !left || !right ) {
+        printf("unknown policy %s, expected one of", !left ? leftName : rightName);
+        for( u32 i = 0; i < BUILTIN_POLICY_COUNT; i++ ) { printf(" %s", BUILTIN_POLICIES[i].name); }
+        printf("\n");
+        return -1;
+    }
+
+    std::vector<GameRules> points = samples ?
+        RandomPoints( axes, samples, seed ) : GridPoints( axes );
+    u32 pointCount = (u32)points.size();
+
+    // one batch per point so every (point, chunk) job can run at once
+    std::vector<BatchState> batches( pointCount );
+    for( u32 i = 0; i < pointCount; i++ ) {
+        batches[i] = CreateBatch( matches, seed );
+        batches[i].rules = points[i];
+    }
+    u32 chunksPerPoint = (matches + SWEEP_CHUNK_LANES - 1) / SWEEP_CHUNK_LANES;
+    std::vector<SweepStats> chunkStats( pointCount * chunksPerPoint, SweepStats{} );
+
+    JobPool pool( threads - 1 );
+    auto start = std::chrono::steady_clock::now();
+    ParallelFor( pool, pointCount * chunksPerPoint, 1, [&]( u32 first, u32 count ) {
+        for( u32 job = first; job < first + count; job++ ) {
+            u32 point = job / chunksPerPoint;
+            u32 lane  = job % chunksPerPoint * SWEEP_CHUNK_LANES;
+            u32 lanes = std::min( SWEEP_CHUNK_LANES, matches - lane );
+            PlaySweepChunk( batches[point], lane, lanes, ticks, SWEEP_TICK_LENGTH, *left, *right, chunkStats[job] );
+        }
+    });
+    f64 seconds = std::chrono::duration<f64>( std::chrono::steady_clock::now() - start ).count();
+
+    std::vector<SweepStats> pointStats( pointCount, SweepStats{} );
+    for( u32 job = 0; job < pointCount * chunksPerPoint; job++ ) {
+        AccumulateStats( pointStats[job / chunksPerPoint], chunkStats[job] );
+    }
+    for( BatchState& batch : batches ) { FreeBatch( batch ); }
+
+    FILE* csv = fopen( csvPath, "w" );
+    FILE* json = jsonPath ? fopen( jsonPath, "w" ) : nullptr;
+    if( !csv || (jsonPath && !json) ) {
+        printf("failed to open %s\n", !csv ? csvPath : jsonPath);
+        return -1;
+    }
+
+    for( u32 p = 0; p < SWEEP_PARAM_COUNT; p++ ) { fprintf( csv, "%s,", SweepParamName((SweepParam)p) ); }
+    fprintf( csv, "points,left_point_share,rally_hits,seconds_per_point,tunnels\n" );
+    if( json ) { fprintf( json, "[\n" ); }
+    for( u32 i = 0; i < pointCount; i++ ) {
+        const SweepStats& stats = pointStats[i];
+        u64 scored = stats.playerPoints + stats.cpuPoints;
+        // fraction of the points the left policy won, not of matches
+        f64 leftShare = scored ? (f64)stats.playerPoints / scored : 0.0;
+        f64 rally     = scored ? (f64)stats.hits / scored : 0.0;
+        f64 duration  = scored ? stats.playTicks * (f64)SWEEP_TICK_LENGTH / scored : 0.0;
+
+        for( u32 p = 0; p < SWEEP_PARAM_COUNT; p++ ) {
+            fprintf( csv, "%g,", RulesField(points[i], (SweepParam)p) );
+        }
+        fprintf( csv, "%llu,%.4f,%.3f,%.3f,%llu\n", (unsigned long long)scored,
+            leftShare, rally, duration, (unsigned long long)stats.tunnels );
+
+        if( json ) {
+            fprintf( json, "  {\"rules\":{" );
+            for( u32 p = 0; p < SWEEP_PARAM_COUNT; p++ ) {
+                fprintf( json, "%s\"%s\":%g", p ? "," : "",
+                    SweepParamName((SweepParam)p), RulesField(points[i], (SweepParam)p) );
+            }
+            fprintf( json, "},\"points\":%llu,\"leftPointShare\":%.4f,\"rallyHits\":%.3f,"
+                "\"secondsPerPoint\":%.3f,\"tunnels\":%llu}%s\n", (unsigned long long)scored,
+                leftShare, rally, duration, (unsigned long long)stats.tunnels,
+                i + 1 < pointCount ? "," : "" );
+        }
+    }
+    if( json ) {
+        fprintf( json, "]\n" );
+        fclose( json );
+    }
+    fclose( csv );
+
+    u64 matchTicks = (u64)pointCount * matches * ticks;
+    printf("points         %u, %u matches each, %u ticks, %s vs %s\n", pointCount, matches, ticks, left->name, right->name);
+    printf("simulated      %llu match ticks in %.3f s, %.1f M ticks/s on %u threads\n",
+        (unsigned long long)matchTicks, seconds, matchTicks / seconds / 1e6, threads);
+    return 0;
+}
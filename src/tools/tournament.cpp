@@ -0,0 +1,163 @@
+// Plays a round robin or swiss tournament between paddle policies on every core.
+// Games stream to the output file as json lines the moment they finish, the
+// standings are printed after every rating period.
+// usage: tournament [-p policy,policy,...] [-f roundrobin|swiss] [-g games per pairing]
+//                   [-r swiss rounds] [-period games per rating period] [-s target score]
+//                   [-n max ticks] [-t threads] [-o results.jsonl]
+#include "./sim/tournament.hpp"
+#include "./sim/jobs.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct TournamentArgs {
+    std::vector<const Policy*> entrants;
+    bool swiss          = false;
+    u32  gamesPerPair   = 100;
+    u32  rounds         = 0;
+    u32  period         = 1000;
+    u32  threads        = 1;
+    const char* output  = "tournament.jsonl";
+    GameSettings settings;
+};
+
+bool ParsePolicies( const char* list, std::vector<const Policy*>& entrants ) {
+    std::string names( list );
+    size_t start = 0;
+    while( start <= names.size() ) {
+        size_t end = names.find( ',', start );
+        if( end == std::string::npos ) { end = names.size(); }
+        std::string name = names.substr( start, end - start );
+        const Policy* policy = FindPolicy( name.c_str() );
+        if( !policy ) {
+            printf("unknown policy %s\n", name.c_str());
+            return false;
+        }
+        entrants.push_back( policy );
+        start = end + 1;
+    }
+    return true;
+}
+
+void PrintStandings( const TournamentArgs& args, const std::vector<Rating>& ratings, u32 games, f64 seconds ) {
+    std::vector<u32> order( ratings.size() );
+    for( u32 i = 0; i < order.size(); i++ ) { order[i] = i; }
+    std::sort( order.begin(), order.end(), [&ratings]( u32 a, u32 b ) {
+        return ratings[a].glicko > ratings[b].glicko;
+    } );
+
+    printf("after %u games, %.2f s\n", games, seconds);
+    printf("  %-10s %8s %8s %19s %7s %7s %7s\n", "policy", "elo", "glicko", "95% interval", "won", "lost", "drawn");
+    for( u32 i : order ) {
+        const Rating& rating = ratings[i];
+        f64 low, high;
+        GlickoInterval( rating, low, high );
+        printf("  %-10s %8.1f %8.1f   [%6.1f, %6.1f] %7u %7u %7u\n",
+            args.entrants[i]->name, rating.elo, rating.glicko, low, high,
+            rating.wins, rating.losses, rating.draws);
+    }
+    fflush(stdout);
+}
+
+int main( int argc, char** argv ) {
+    TournamentArgs args;
+    args.threads = std::max( std::thread::hardware_concurrency(), 1u );
+    for( int i = 1; i + 1 < argc; i += 2 ) {
+        if( strcmp(argv[i], "-p") == 0 ) {
+            if( !ParsePolicies(argv[i + 1], args.entrants) ) { return -1; }
+        }
+        else if( strcmp(argv[i], "-f") == 0 )      { args.swiss = strcmp(argv[i + 1], "swiss") == 0; }
+        else if( strcmp(argv[i], "-g") == 0 )      { args.gamesPerPair = std::max( atoi(argv[i + 1]), 1 ); }
+        else if( strcmp(argv[i], "-r") == 0 )      { args.rounds = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-period") == 0 ) { args.period = std::max( atoi(argv[i + 1]), 1 ); }
+        else if( strcmp(argv[i], "-s") == 0 )      { args.settings.targetScore = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-n") == 0 )      { args.settings.maxTicks = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-t") == 0 )      { args.threads = std::max( atoi(argv[i + 1]), 1 ); }
+        else if( strcmp(argv[i], "-o") == 0 )      { args.output = argv[i + 1]; }
+    }
+    if( args.entrants.empty() ) {
+        for( u32 i = 0; i < BUILTIN_POLICY_COUNT; i++ ) { args.entrants.push_back( &BUILTIN_POLICIES[i] ); }
+    }
+    u32 entrants = (u32)args.entrants.size();
+    if( entrants < 2 ) {
+        printf("a tournament needs at least two policies\n");
+        return -1;
+    }
+    if( args.rounds == 0 ) {
+        // enough rounds to sort the field out, plus a couple
+        args.rounds = (u32)ceil( log2((f64)entrants) ) + 2;
+    }
+
+    FILE* output = fopen( args.output, "w" );
+    if( !output ) {
+        printf("failed to open %s\n", args.output);
+        return -1;
+    }
+
+    JobPool pool( args.threads - 1 );
+    std::mutex outputLock;
+    std::vector<Rating> ratings( entrants, InitialRating() );
+    std::vector<u8> met( entrants * entrants );
+    std::vector<GameResult> results;
+    u32 played = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    // plays games in parallel, streaming each one out as it finishes,
+    // then rates them in game order so ratings don't depend on the scheduling
+    auto playPeriod = [&]( const Pairing* pairings, u32 count ) {
+        results.resize( count );
+        ParallelFor( pool, count, 1, [&]( u32 first, u32 n ) {
+            for( u32 i = first; i < first + n; i++ ) {
+                Pairing pairing = pairings[i];
+                GameResult game = PlayGame(
+                    *args.entrants[pairing.left], *args.entrants[pairing.right],
+                    args.settings, played + i
+                );
+                game.left  = pairing.left;
+                game.right = pairing.right;
+                results[i] = game;
+
+                std::lock_guard<std::mutex> guard( outputLock );
+                fprintf( output, "{\"game\":%u,\"left\":\"%s\",\"right\":\"%s\",\"score\":[%u,%u],\"ticks\":%u}\n",
+                    game.id, args.entrants[game.left]->name, args.entrants[game.right]->name,
+                    game.leftScore, game.rightScore, game.ticks );
+                fflush( output );
+            }
+        } );
+        for( const GameResult& game : results ) { UpdateElo( ratings, game ); }
+        UpdateGlicko( ratings, results.data(), count );
+        played += count;
+        f64 seconds = std::chrono::duration<f64>( std::chrono::steady_clock::now() - start ).count();
+        PrintStandings( args, ratings, played, seconds );
+    };
+
+    if( args.swiss ) {
+        for( u32 round = 0; round < args.rounds; round++ ) {
+            std::vector<Pairing> pairings = SwissPairings( ratings, met, args.gamesPerPair );
+            printf("round %u, %zu games\n", round + 1, pairings.size());
+            playPeriod( pairings.data(), (u32)pairings.size() );
+        }
+    } else {
+        std::vector<Pairing> pairings = RoundRobinPairings( entrants, args.gamesPerPair );
+        // shuffled so every rating period has a mix of pairings
+        u64 key = MatchRngKey( args.settings.seed, ~0u );
+        for( u32 i = (u32)pairings.size(); i > 1; i-- ) {
+            std::swap( pairings[i - 1], pairings[Squares32(i, key) % i] );
+        }
+        for( u32 first = 0; first < pairings.size(); first += args.period ) {
+            u32 count = std::min( args.period, (u32)pairings.size() - first );
+            playPeriod( pairings.data() + first, count );
+        }
+    }
+
+    fclose( output );
+    printf("%u games written to %s\n", played, args.output);
+    return 0;
+}
@@ -0,0 +1,62 @@
+// Steps a VecEnv with random actions and reports environment steps per second
+// on one core, the number a trainer's rollout loop is limited by.
+// usage: vecenv_bench [-e envs] [-n steps] [-k frame skip] [-a cpu aim x] [-c cpu speed]
+#include "./sim/vecenv.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+const u64 VEC_ENV_BENCH_SEED = 31;
+
+int main( int argc, char** argv ) {
+    VecEnvConfig config;
+    config.envCount = 256;
+    config.seed     = VEC_ENV_BENCH_SEED;
+    u32 steps = 20000;
+    for( int i = 1; i + 1 < argc; i += 2 ) {
+        if( strcmp(argv[i], "-e") == 0 )      { config.envCount  = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-n") == 0 ) { steps            = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-k") == 0 ) { config.frameSkip = (u32)atoi(argv[i + 1]); }
+        else if( strcmp(argv[i], "-a") == 0 ) { config.rules.cpuAimX  = (f32)atof(argv[i + 1]); }
+        else if( strcmp(argv[i], "-c") == 0 ) { config.rules.cpuSpeed = (f32)atof(argv[i + 1]); }
+    }
+
+    VecEnv env( config );
+    std::vector<f32> observations( config.envCount * VEC_ENV_OBSERVATION_SIZE );
+    std::vector<f32> rewards( config.envCount );
+    std::vector<u8>  dones( config.envCount );
+    std::vector<u8>  actions( config.envCount );
+    env.Reset( observations.data() );
+
+    u64 key = MatchRngKey( VEC_ENV_BENCH_SEED, ~0u );
+    // summed per env and counted once its episode ends
+    std::vector<f64> episodeRewards( config.envCount );
+    f64 finishedReward = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for( u32 step = 0; step < steps; step++ ) {
+        for( u32 i = 0; i < config.envCount; i++ ) {
+            actions[i] = (u8)(Squares32( (u64)step * config.envCount + i, key ) % ENV_ACTION_COUNT);
+        }
+        env.Step( actions.data(), observations.data(), rewards.data(), dones.data() );
+        for( u32 i = 0; i < config.envCount; i++ ) {
+            episodeRewards[i] += rewards[i];
+            if( dones[i] ) {
+                finishedReward += episodeRewards[i];
+                episodeRewards[i] = 0.0;
+            }
+        }
+    }
+    f64 seconds = std::chrono::duration<f64>( std::chrono::steady_clock::now() - start ).count();
+
+    u64 envSteps = (u64)steps * config.envCount;
+    printf("envs           %u, frame skip %u\n", config.envCount, config.frameSkip);
+    printf("env steps      %llu in %.3f s, %.0f steps/s, %.1f M ticks/s\n",
+        (unsigned long long)envSteps, seconds, envSteps / seconds,
+        envSteps * config.frameSkip / seconds / 1e6);
+    printf("episodes       %llu, reward per episode %.2f\n",
+        (unsigned long long)env.EpisodeCount(),
+        env.EpisodeCount() ? finishedReward / env.EpisodeCount() : 0.0);
+    return 0;
+}